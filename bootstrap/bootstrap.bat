@@ -10,7 +10,7 @@ echo ********************************************
 echo *** Trying Microsoft Visual Studio 14... ***
 echo ********************************************
 call "C:\Program Files (x86)\Microsoft Visual Studio 14.0\VC\vcvarsall.bat" || goto msvc12
-cl /EHsc src\*.cpp /Fotemp\ /Fe..\bin\mutt && goto deps_msvc
+cl /EHsc src\*.cpp ..\src\mutiny\internal\lodepng.cpp /Fotemp\ /Fe..\bin\mutt && goto deps_msvc
 
 :msvc12
 echo.
@@ -18,7 +18,7 @@ echo ********************************************
 echo *** Trying Microsoft Visual Studio 12... ***
 echo ********************************************
 call "C:\Program Files (x86)\Microsoft Visual Studio 12.0\VC\vcvarsall.bat" || goto msvc11
-cl /EHsc src\*.cpp /Fotemp\ /Fe..\bin\mutt && goto deps_msvc
+cl /EHsc src\*.cpp ..\src\mutiny\internal\lodepng.cpp /Fotemp\ /Fe..\bin\mutt && goto deps_msvc
 
 :msvc11
 echo.
@@ -26,7 +26,7 @@ echo ********************************************
 echo *** Trying Microsoft Visual Studio 11... ***
 echo ********************************************
 call "C:\Program Files (x86)\Microsoft Visual Studio 11.0\VC\vcvarsall.bat" || goto msvc10
-cl /EHsc src\*.cpp /Fotemp\ /Fe..\bin\mutt && goto deps_msvc
+cl /EHsc src\*.cpp ..\src\mutiny\internal\lodepng.cpp /Fotemp\ /Fe..\bin\mutt && goto deps_msvc
 
 :msvc10
 echo.
@@ -34,21 +34,21 @@ echo ********************************************
 echo *** Trying Microsoft Visual Studio 10... ***
 echo ********************************************
 call "C:\Program Files (x86)\Microsoft Visual Studio 10.0\VC\vcvarsall.bat" || goto clang
-cl /EHsc src\*.cpp /Fotemp\ /Fe..\bin\mutt && goto deps_msvc
+cl /EHsc src\*.cpp ..\src\mutiny\internal\lodepng.cpp /Fotemp\ /Fe..\bin\mutt && goto deps_msvc
 
 :clang
 echo.
 echo ****************************************
 echo *** Trying LLVM / Clang Compiler...  ***
 echo ****************************************
-clang++ src\*.cpp -o ..\bin\mutt.exe && goto deps_mingw
+clang++ src\*.cpp ..\src\mutiny\internal\lodepng.cpp -o ..\bin\mutt.exe && goto deps_mingw
 
 :gcc
 echo.
 echo ***********************************
 echo *** Trying GNU C++ Compiler...  ***
 echo ***********************************
-g++ src\*.cpp -o ..\bin\mutt && goto deps_mingw
+g++ src\*.cpp ..\src\mutiny\internal\lodepng.cpp -o ..\bin\mutt && goto deps_mingw
 
 echo.
 echo !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
@@ -58,7 +58,7 @@ cd windows
 7z x i686-4.9.1-release-posix-dwarf-rt_v3-rev2.7z
 cd ..
 set PATH=%PATH%;%~dp0\windows\mingw32\bin
-g++ -D INTERNAL_GCC src\*.cpp -o ..\bin\mutt
+g++ -D INTERNAL_GCC src\*.cpp ..\src\mutiny\internal\lodepng.cpp -o ..\bin\mutt
 copy windows\mingw32\bin\libgcc_s_dw2-1.dll ..\bin
 copy "windows\mingw32\bin\libstdc++-6.dll" ..\bin
 copy windows\mingw32\bin\libwinpthread-1.dll ..\bin
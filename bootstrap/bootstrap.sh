@@ -12,13 +12,13 @@ mkdir -p "$PREFIX/bin"
 which g++
 
 if [ $? = 0 ]; then
-  g++ -g "$ABSOLUTE_BOOTSTRAP_PATH/src/"*.cpp -o "$PREFIX/bin/mutt"
+  g++ -g "$ABSOLUTE_BOOTSTRAP_PATH/src/"*.cpp "$PREFIX/src/mutiny/internal/lodepng.cpp" -o "$PREFIX/bin/mutt"
   exit
 fi
 
 which clang++
 
 if [ $? = 0 ]; then
-  clang++ -g "$ABSOLUTE_BOOTSTRAP_PATH/src/"*.cpp -o "$PREFIX/bin/mutt"
+  clang++ -g "$ABSOLUTE_BOOTSTRAP_PATH/src/"*.cpp "$PREFIX/src/mutiny/internal/lodepng.cpp" -o "$PREFIX/bin/mutt"
   exit
 fi
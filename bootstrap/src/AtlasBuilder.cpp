@@ -0,0 +1,458 @@
+#include "AtlasBuilder.h"
+#include "FileInfo.h"
+#include "Util.h"
+#include "cwrapper.h"
+#include "features.h"
+
+#include "../../src/mutiny/internal/lodepng.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+const char* AtlasBuilder::OUTPUT_DIRECTORY = "_atlas";
+
+static bool compareImageHeight(shared<AtlasImage> a, shared<AtlasImage> b)
+{
+  if(a->height != b->height)
+  {
+    return a->height > b->height;
+  }
+
+  return a->width > b->width;
+}
+
+shared<AtlasBuilder> AtlasBuilder::create(std::string root)
+{
+  shared<AtlasBuilder> rtn = alloc_shared<AtlasBuilder>();
+
+  rtn->root = root;
+  rtn->scanMarkers("");
+  std::sort(rtn->markers.begin(), rtn->markers.end());
+
+  return rtn;
+}
+
+void AtlasBuilder::scanMarkers(std::string relativePath)
+{
+  std::string path = root;
+
+  if(relativePath != "")
+  {
+    path += Util::fixPath("/" + relativePath);
+  }
+
+  shared<Dir> dir;
+
+  try
+  {
+    dir = Dir::opendir(path);
+  }
+  catch(std::exception& e)
+  {
+    return;
+  }
+
+  shared<Dirent> dirent = dir->readdir();
+
+  while(dirent.get() != NULL)
+  {
+    std::string name = dirent->d_name();
+    std::string child = name;
+
+    if(relativePath != "")
+    {
+      child = relativePath + "/" + name;
+    }
+
+    if(name.at(0) == '.' || child == OUTPUT_DIRECTORY)
+    {
+      dirent = dir->readdir();
+      continue;
+    }
+
+    if(Dir::isdir(path + DIR_CHAR + name) == true)
+    {
+      scanMarkers(child);
+    }
+    else if(name == "atlas")
+    {
+      markers.push_back(relativePath);
+    }
+
+    dirent = dir->readdir();
+  }
+}
+
+void AtlasBuilder::buildOutOfDateAtlases()
+{
+  std::string outputDir = root + Util::fixPath("/" + std::string(OUTPUT_DIRECTORY));
+
+  if(isOutOfDate() == false)
+  {
+    return;
+  }
+
+  std::cout << "Packing texture atlases: " << outputDir << std::endl;
+
+  try
+  {
+    std::vector<shared<FileInfo> > stale;
+    FileInfo::scanDirectory(outputDir, false, stale);
+
+    for(int i = 0; i < stale.size(); i++)
+    {
+      Dir::remove(stale.at(i)->getAbsolutePath());
+    }
+  }
+  catch(std::exception& e) { }
+
+  if(markers.size() < 1)
+  {
+    return;
+  }
+
+  try
+  {
+    Dir::mkdir_r(outputDir);
+  }
+  catch(std::exception& e)
+  {
+    std::cout << "Failed to create: " << outputDir << std::endl;
+
+    return;
+  }
+
+  loadImages();
+
+  std::vector<std::string> groups;
+
+  for(int i = 0; i < images.size(); i++)
+  {
+    if(std::find(groups.begin(), groups.end(), images.at(i)->group) == groups.end())
+    {
+      groups.push_back(images.at(i)->group);
+    }
+  }
+
+  for(int i = 0; i < groups.size(); i++)
+  {
+    packGroup(groups.at(i));
+  }
+
+  for(int i = 0; i < pages.size(); i++)
+  {
+    writePage(pages.at(i), i);
+  }
+
+  writeIndex();
+}
+
+bool AtlasBuilder::isOutOfDate()
+{
+  std::string indexPath = root + Util::fixPath("/" + std::string(OUTPUT_DIRECTORY) + "/atlas.txt");
+  shared<FileInfo> index;
+
+  try
+  {
+    index = FileInfo::create(indexPath);
+  }
+  catch(std::exception& e)
+  {
+    // Nothing has been built yet so only markers make this out of date
+    return markers.size() > 0;
+  }
+
+  std::vector<std::string> built;
+  std::ifstream file(indexPath.c_str());
+  std::string line;
+
+  while(std::getline(file, line))
+  {
+    if(line.substr(0, 10) == "directory ")
+    {
+      built.push_back(line.substr(10));
+    }
+  }
+
+  if(built != markers)
+  {
+    return true;
+  }
+
+  for(int i = 0; i < markers.size(); i++)
+  {
+    std::vector<shared<FileInfo> > files;
+    std::string path = root;
+
+    if(markers.at(i) != "")
+    {
+      path += Util::fixPath("/" + markers.at(i));
+    }
+
+    shared<Dir> dir = Dir::opendir(path);
+    shared<Dirent> dirent = dir->readdir();
+
+    while(dirent.get() != NULL)
+    {
+      std::string name = dirent->d_name();
+
+      if(name.at(0) != '.' && Dir::isdir(path + DIR_CHAR + name) == false)
+      {
+        if(FileInfo::create(path + DIR_CHAR + name)->getModified() > index->getModified())
+        {
+          return true;
+        }
+      }
+
+      dirent = dir->readdir();
+    }
+  }
+
+  return false;
+}
+
+void AtlasBuilder::loadImages()
+{
+  for(int i = 0; i < markers.size(); i++)
+  {
+    std::string path = root;
+    std::string prefix;
+
+    if(markers.at(i) != "")
+    {
+      path += Util::fixPath("/" + markers.at(i));
+      prefix = markers.at(i) + "/";
+    }
+
+    std::string group = "default";
+    std::ifstream marker((path + DIR_CHAR + "atlas").c_str());
+    marker >> group;
+
+    shared<Dir> dir = Dir::opendir(path);
+    shared<Dirent> dirent = dir->readdir();
+
+    while(dirent.get() != NULL)
+    {
+      std::string name = dirent->d_name();
+
+      if(name.at(0) == '.' || FileInfo::getSuffix(name) != "png")
+      {
+        dirent = dir->readdir();
+        continue;
+      }
+
+      shared<AtlasImage> image = alloc_shared<AtlasImage>();
+      unsigned char* pixels = NULL;
+
+      if(lodepng_decode32_file(&pixels, &image->width, &image->height,
+        (path + DIR_CHAR + name).c_str()) != 0)
+      {
+        std::cout << "Failed to decode: " << path << DIR_CHAR << name << std::endl;
+        dirent = dir->readdir();
+        continue;
+      }
+
+      image->pixels.assign(pixels, pixels + image->width * image->height * 4);
+      free(pixels);
+
+      image->path = prefix + name.substr(0, name.length() - 4);
+      image->group = group;
+      image->page = -1;
+      images.push_back(image);
+
+      dirent = dir->readdir();
+    }
+  }
+}
+
+void AtlasBuilder::packGroup(std::string group)
+{
+  std::vector<shared<AtlasImage> > remaining;
+
+  for(int i = 0; i < images.size(); i++)
+  {
+    shared<AtlasImage> image = images.at(i);
+
+    if(image->group != group)
+    {
+      continue;
+    }
+
+    // Anything too big to share a page is left as a standalone texture
+    if(image->width + PADDING * 2 > MAX_SIZE || image->height + PADDING * 2 > MAX_SIZE)
+    {
+      std::cout << "Not atlased (too large): " << image->path << std::endl;
+      continue;
+    }
+
+    remaining.push_back(image);
+  }
+
+  std::sort(remaining.begin(), remaining.end(), compareImageHeight);
+
+  while(remaining.size() > 0)
+  {
+    AtlasPage page = {};
+    std::stringstream name;
+    name << group << "_" << pages.size();
+    page.name = name.str();
+    page.width = MAX_SIZE;
+    page.height = MAX_SIZE;
+
+    // Smallest power of two page that holds everything left, otherwise
+    // fill a full size page and carry the rest over to the next one
+    for(int size = 256; size <= MAX_SIZE; size *= 2)
+    {
+      int width = size;
+      int height = size / 2;
+
+      if(pack(remaining, width, height, pages.size(), false) == remaining.size())
+      {
+        page.width = width;
+        page.height = height;
+        break;
+      }
+
+      if(pack(remaining, width, width, pages.size(), false) == remaining.size())
+      {
+        page.width = width;
+        page.height = width;
+        break;
+      }
+    }
+
+    pack(remaining, page.width, page.height, pages.size(), true);
+    pages.push_back(page);
+
+    std::vector<shared<AtlasImage> > unplaced;
+
+    for(int i = 0; i < remaining.size(); i++)
+    {
+      if(remaining.at(i)->page == -1)
+      {
+        unplaced.push_back(remaining.at(i));
+      }
+    }
+
+    remaining = unplaced;
+  }
+}
+
+int AtlasBuilder::pack(std::vector<shared<AtlasImage> >& images, int width,
+  int height, int page, bool commit)
+{
+  int x = 0;
+  int y = 0;
+  int shelfHeight = 0;
+  int placed = 0;
+
+  for(int i = 0; i < images.size(); i++)
+  {
+    int imageWidth = images.at(i)->width + PADDING * 2;
+    int imageHeight = images.at(i)->height + PADDING * 2;
+
+    if(imageWidth > width)
+    {
+      continue;
+    }
+
+    if(x + imageWidth > width)
+    {
+      x = 0;
+      y += shelfHeight;
+      shelfHeight = 0;
+    }
+
+    if(y + imageHeight > height)
+    {
+      continue;
+    }
+
+    if(commit == true)
+    {
+      images.at(i)->page = page;
+      images.at(i)->x = x + PADDING;
+      images.at(i)->y = y + PADDING;
+    }
+
+    x += imageWidth;
+    shelfHeight = std::max(shelfHeight, imageHeight);
+    placed++;
+  }
+
+  return placed;
+}
+
+void AtlasBuilder::writePage(AtlasPage& page, int index)
+{
+  std::vector<unsigned char> pixels(page.width * page.height * 4, 0);
+
+  for(int i = 0; i < images.size(); i++)
+  {
+    shared<AtlasImage> image = images.at(i);
+
+    if(image->page != index)
+    {
+      continue;
+    }
+
+    // The padding is filled by extending the edge pixels so filtering at
+    // the border of an image never picks up its neighbours
+    for(int dy = -PADDING; dy < (int)image->height + PADDING; dy++)
+    {
+      int sy = std::min(std::max(dy, 0), (int)image->height - 1);
+
+      for(int dx = -PADDING; dx < (int)image->width + PADDING; dx++)
+      {
+        int sx = std::min(std::max(dx, 0), (int)image->width - 1);
+        int source = (sy * image->width + sx) * 4;
+        int destination = ((image->y + dy) * page.width + image->x + dx) * 4;
+
+        for(int c = 0; c < 4; c++)
+        {
+          pixels.at(destination + c) = image->pixels.at(source + c);
+        }
+      }
+    }
+  }
+
+  std::string path = root + Util::fixPath("/" + std::string(OUTPUT_DIRECTORY) +
+    "/" + page.name + ".png");
+
+  if(lodepng_encode32_file(path.c_str(), &pixels.at(0), page.width, page.height) != 0)
+  {
+    std::cout << "Failed to write: " << path << std::endl;
+  }
+}
+
+void AtlasBuilder::writeIndex()
+{
+  std::string path = root + Util::fixPath("/" + std::string(OUTPUT_DIRECTORY) + "/atlas.txt");
+  std::ofstream file(path.c_str());
+
+  for(int i = 0; i < markers.size(); i++)
+  {
+    file << "directory " << markers.at(i) << std::endl;
+  }
+
+  for(int p = 0; p < pages.size(); p++)
+  {
+    file << "page " << pages.at(p).width << " " << pages.at(p).height << " "
+      << pages.at(p).name << std::endl;
+
+    for(int i = 0; i < images.size(); i++)
+    {
+      shared<AtlasImage> image = images.at(i);
+
+      if(image->page != p)
+      {
+        continue;
+      }
+
+      file << "image " << image->x << " " << image->y << " " << image->width
+        << " " << image->height << " " << image->path << std::endl;
+    }
+  }
+}
@@ -0,0 +1,61 @@
+#ifndef ATLASBUILDER_H
+#define ATLASBUILDER_H
+
+#include "features.h"
+
+#include <memory>
+#include <vector>
+#include <string>
+
+struct AtlasImage
+{
+  std::string path;
+  std::string group;
+  unsigned width;
+  unsigned height;
+  std::vector<unsigned char> pixels;
+  int page;
+  int x;
+  int y;
+};
+
+struct AtlasPage
+{
+  std::string name;
+  int width;
+  int height;
+};
+
+// Packs the PNG images of every asset directory containing an "atlas"
+// marker file into shared texture pages. The marker holds the name of the
+// atlas group so several directories can share pages. The pages and a
+// lookup table mapping each image path to its page and rectangle are
+// written to the _atlas directory for Texture2d to resolve at runtime.
+class AtlasBuilder
+{
+public:
+  static const char* OUTPUT_DIRECTORY;
+
+  static shared<AtlasBuilder> create(std::string root);
+  void buildOutOfDateAtlases();
+
+private:
+  static const int MAX_SIZE = 2048;
+  static const int PADDING = 2;
+
+  std::string root;
+  std::vector<std::string> markers;
+  std::vector<shared<AtlasImage> > images;
+  std::vector<AtlasPage> pages;
+
+  void scanMarkers(std::string relativePath);
+  bool isOutOfDate();
+  void loadImages();
+  void packGroup(std::string group);
+  int pack(std::vector<shared<AtlasImage> >& images, int width, int height, int page, bool commit);
+  void writePage(AtlasPage& page, int index);
+  void writeIndex();
+
+};
+
+#endif
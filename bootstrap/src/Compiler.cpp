@@ -265,9 +265,28 @@ void Compiler::link(std::string output)
     libsFragment += " " + libs.at(i);
   }
 
+  bool headless = false;
+  std::vector<std::string> defines = environment->getDefines();
+
+  for(int i = 0; i < defines.size(); i++)
+  {
+    if(defines.at(i) == "MUTINY_HEADLESS")
+    {
+      headless = true;
+    }
+  }
+
   if(environment->isMutinyAvailable() == true)
   {
-    if(FileInfo::getFileName(name) == "em++")
+    if(headless == true)
+    {
+      // GL entry points are provided by the engine itself (internal/NullGl)
+      if(std::string(PLATFORM_NAME) != "windows")
+      {
+        libsFragment += " -lpthread";
+      }
+    }
+    else if(FileInfo::getFileName(name) == "em++")
     {
 
     }
@@ -282,7 +301,7 @@ void Compiler::link(std::string output)
     }
     else
     {
-      libsFragment += " -lGL -lGLEW -lglut -logg -lvorbis -lvorbisfile -lopenal";
+      libsFragment += " -lGL -lGLEW -lglut -logg -lvorbis -lvorbisfile -lopenal -lpthread";
     }
   }
 
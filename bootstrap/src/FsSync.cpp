@@ -184,6 +184,11 @@ void FsSync::removeOrphanedFiles(std::string destination, std::string path,
   {
     bool exists = false;
 
+    if(isPreserved(path + splitter + files.at(i)) == true)
+    {
+      continue;
+    }
+
     if(Directory::exists(destination + splitter + path + "/" + files.at(i)))
     {
       removeOrphanedFiles(destination, path + splitter + files.at(i), sources);
@@ -226,7 +231,8 @@ void FsSync::removeOrphanedDirectories(std::string destination,
   {
     bool exists = false;
 
-    if(File::exists(destination + splitter + path + "/" + files.at(i)))
+    if(File::exists(destination + splitter + path + "/" + files.at(i)) ||
+      isPreserved(path + splitter + files.at(i)) == true)
     {
       continue;
     }
@@ -337,6 +343,36 @@ void FsSync::createMissingDirectories(std::string destination,
   }
 }
 
+bool FsSync::isPreserved(std::string path)
+{
+  for(size_t i = 0; i < preserved.size(); i++)
+  {
+    std::string pattern = preserved.at(i);
+
+    if(pattern == path)
+    {
+      return true;
+    }
+
+    // A leading '*' matches any path ending with the rest of the pattern
+    if(pattern.length() > 1 && pattern.at(0) == '*' &&
+      path.length() >= pattern.length() - 1 &&
+      path.substr(path.length() - (pattern.length() - 1)) == pattern.substr(1))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// Generated output living in the destination that must survive the
+// removal of files missing from the sources
+void FsSync::preserve(std::string path)
+{
+  preserved.push_back(path);
+}
+
 void FsSync::sync(std::string destination, std::vector<std::string>& sources)
 {
   if(Directory::exists(destination))
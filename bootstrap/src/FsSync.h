@@ -15,7 +15,12 @@ class FsSync
   void copyRequiredFiles(std::string destination,
     std::string path, std::vector<std::string>& sources);
 
+  bool isPreserved(std::string path);
+
+  std::vector<std::string> preserved;
+
 public:
   void sync(std::string destination, std::vector<std::string>& sources);
+  void preserve(std::string path);
 
 };
@@ -6,6 +6,7 @@
 #include "Compiler.h"
 #include "features.h"
 #include "FsSync.h"
+#include "AtlasBuilder.h"
 
 #include <iostream>
 
@@ -92,10 +93,16 @@ void ProjectBuilder::obtainOutputFilename()
 bool ProjectBuilder::syncAssetDirectories(std::vector<std::string> assetDirectories)
 {
   FsSync fsSync;
+  std::string shareDirectory = Util::fixPath("build/" +
+    std::string(PLATFORM_NAME)+"/share/" + outputFilename);
 
-  fsSync.sync(Util::fixPath("build/" +
-    std::string(PLATFORM_NAME)+"/share/" + outputFilename),
-    assetDirectories);
+  fsSync.preserve(AtlasBuilder::OUTPUT_DIRECTORY);
+  // Binary meshes the engine writes beside each .obj it parses
+  fsSync.preserve("*.mesh");
+  fsSync.sync(shareDirectory, assetDirectories);
+
+  shared<AtlasBuilder> atlasBuilder = AtlasBuilder::create(shareDirectory);
+  atlasBuilder->buildOutOfDateAtlases();
 
   // TODO: Return true only if changed (to avoid em++ re-linking).
 
@@ -51,6 +51,7 @@ std::string Dir::getcwd()
 void Dir::mkdir_r(std::string path)
 {
   std::vector<std::string> parts;
+  bool absolute = path.length() > 0 && path.at(0) == DIR_CHAR;
 
   while(true)
   {
@@ -68,6 +69,12 @@ void Dir::mkdir_r(std::string path)
   std::string tpath;
   std::string sep;
 
+  // The leading separator of an absolute path is lost while splitting
+  if(absolute == true)
+  {
+    sep = DIR_CHAR;
+  }
+
   for(int i = parts.size() - 1; i >= 0; i--)
   {
     tpath += sep + parts.at(i);
@@ -1,10 +1,15 @@
 uniform mat4 in_Projection;
 uniform mat4 in_View;
-uniform mat4 in_Model;
 
 attribute vec3 in_Position;
+#ifdef MUTINY_INSTANCING
+attribute mat4 in_InstanceModel;
+#else
+uniform mat4 in_Model;
+#define in_InstanceModel in_Model
+#endif
 
 void main()
 {
-  gl_Position = in_Projection * in_View * in_Model * vec4(in_Position, 1);
+  gl_Position = in_Projection * in_View * in_InstanceModel * vec4(in_Position, 1);
 }
@@ -1,15 +1,20 @@
 uniform mat4 in_Projection;
 uniform mat4 in_View;
-uniform mat4 in_Model;
 
 attribute vec3 in_Position;
 attribute vec2 in_Uv;
 attribute vec3 in_Normal;
+#ifdef MUTINY_INSTANCING
+attribute mat4 in_InstanceModel;
+#else
+uniform mat4 in_Model;
+#define in_InstanceModel in_Model
+#endif
 
 varying vec2 ex_Uv;
 
 void main()
 {
   ex_Uv = in_Uv;
-  gl_Position = in_Projection * in_View * in_Model * vec4(in_Position, 1);
+  gl_Position = in_Projection * in_View * in_InstanceModel * vec4(in_Position, 1);
 }
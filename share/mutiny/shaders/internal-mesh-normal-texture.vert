@@ -1,11 +1,18 @@
 uniform mat4 in_Projection;
 uniform mat4 in_View;
-uniform mat4 in_Model;
-uniform mat4 in_NormalMatrix;
 
 attribute vec3 in_Position;
 attribute vec2 in_Uv;
 attribute vec3 in_Normal;
+#ifdef MUTINY_INSTANCING
+attribute mat4 in_InstanceModel;
+attribute mat4 in_InstanceNormalMatrix;
+#else
+uniform mat4 in_Model;
+uniform mat4 in_NormalMatrix;
+#define in_InstanceModel in_Model
+#define in_InstanceNormalMatrix in_NormalMatrix
+#endif
 
 varying vec2 ex_Uv;
 varying vec3 ex_LightPos;
@@ -15,9 +22,9 @@ varying vec3 ex_N;
 
 void main()
 {
-  ex_N = normalize(in_NormalMatrix * vec4(in_Normal, 1)).xyz;
-  ex_V = vec3(in_View * in_Model * vec4(in_Position, 1)); 
+  ex_N = normalize(in_InstanceNormalMatrix * vec4(in_Normal, 1)).xyz;
+  ex_V = vec3(in_View * in_InstanceModel * vec4(in_Position, 1)); 
   ex_Uv = in_Uv;
   ex_LightPos = vec4(in_View * vec4(7, 10, 13, 1)).xyz;
-  gl_Position = in_Projection * in_View * in_Model * vec4(in_Position, 1);
+  gl_Position = in_Projection * in_View * in_InstanceModel * vec4(in_Position, 1);
 }
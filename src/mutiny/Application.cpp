@@ -5,6 +5,7 @@
 #include "Material.h"
 #include "Screen.h"
 #include "Time.h"
+#include "Profiler.h"
 #include "Input.h"
 #include "RenderTexture.h"
 #include "Resources.h"
@@ -16,13 +17,13 @@
 #include "Graphics.h"
 #include "Transform.h"
 #include "Mesh.h"
+#include "StaticBatchingUtility.h"
 #include "Exception.h"
 #include "internal/platform.h"
 
 #include "internal/Util.h"
 #include "internal/CWrapper.h"
-
-#include <GL/glew.h>
+#include "internal/OpenGl.h"
 
 #ifdef USE_SDL
   #include <SDL/SDL.h>
@@ -43,6 +44,7 @@
 #include <unistd.h>
 #endif
 
+#include <cstdlib>
 #include <ctime>
 #include <functional>
 #include <iostream>
@@ -61,6 +63,12 @@ void Application::init(int argc, char* argv[])
   context.reset(new Context());
 
   context->running = false;
+  context->transformStore = internal::TransformStore::create();
+  context->renderQueue = internal::RenderQueue::create();
+  context->guiDrawList = internal::GuiDrawList::create();
+  context->textLayoutCache = internal::TextLayoutCache::create();
+  context->asyncLoader = internal::AsyncLoader::create();
+  context->resourceCache = internal::ResourceCache::create();
   context->argc = argc;
 
   for(int i = 0; i < argc; i++)
@@ -70,6 +78,8 @@ void Application::init(int argc, char* argv[])
 
   srand(time(NULL));
   setupPaths();
+  context->resourceIndex = internal::ResourceIndex::create(context->dataPath,
+    context->engineDataPath);
 
 #ifdef USE_SDL
   if(SDL_Init(SDL_INIT_EVERYTHING) == -1)
@@ -140,6 +150,8 @@ void Application::init(int argc, char* argv[])
   //  throw std::exception();
   //}
 
+  detectCapabilities();
+
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
   glEnable(GL_BLEND);
   glEnable(GL_DEPTH_TEST);
@@ -230,6 +242,74 @@ bool Application::isValidPrefix(std::string path, std::string basename)
 #endif
 }
 
+// Emscripten links every GL entry point whether or not the browser's
+// WebGL provides it, so support is read from the context rather than
+// inferred from the function pointers
+void Application::detectCapabilities()
+{
+  const char* version = (const char*)glGetString(GL_VERSION);
+  const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+  std::string versionString;
+  std::string extensionString;
+  int major = 0;
+  int minor = 0;
+  GLint maxAttributes = 0;
+
+  if(version != NULL)
+  {
+    versionString = version;
+  }
+
+  if(extensions != NULL)
+  {
+    extensionString = extensions;
+  }
+
+  // Desktop versions begin with the number, GLES and WebGL ones with
+  // "OpenGL ES " followed by it
+  size_t start = versionString.find("OpenGL ES ");
+
+  if(start != std::string::npos)
+  {
+    start += 10;
+  }
+  else
+  {
+    start = versionString.find_first_of("0123456789");
+  }
+
+  if(start != std::string::npos)
+  {
+    major = atoi(versionString.c_str() + start);
+    size_t dot = versionString.find('.', start);
+
+    if(dot != std::string::npos)
+    {
+      minor = atoi(versionString.c_str() + dot + 1);
+    }
+  }
+
+  bool es = versionString.find("OpenGL ES ") != std::string::npos;
+
+  context->vertexArrays = glGenVertexArrays != NULL && glBindVertexArray != NULL &&
+    (major >= 3 ||
+    extensionString.find("GL_ARB_vertex_array_object") != std::string::npos ||
+    extensionString.find("OES_vertex_array_object") != std::string::npos);
+
+  // As with vertex arrays the entry points exist on Emscripten whether or
+  // not the context has instancing so the version and extensions decide.
+  // The built-in mesh shaders need three vertex attributes and two mat4
+  // instance attributes, more than the eight GLES2 guarantees.
+  glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxAttributes);
+
+  context->instancing = glDrawElementsInstanced != NULL &&
+    glVertexAttribDivisor != NULL && maxAttributes >= 11 &&
+    ((es == true && major >= 3) || (es == false && (major > 3 || (major == 3 && minor >= 3))) ||
+    extensionString.find("GL_ARB_instanced_arrays") != std::string::npos ||
+    extensionString.find("ANGLE_instanced_arrays") != std::string::npos ||
+    extensionString.find("EXT_instanced_arrays") != std::string::npos);
+}
+
 void Application::setupPaths()
 {
   std::string dirname;
@@ -349,6 +429,16 @@ void Application::run()
   }
 
   #endif
+#elif defined(USE_HEADLESS)
+  while(context->running == true)
+  {
+    loop();
+  }
+
+  for(size_t i = 0; i < context->gameObjects.size(); i++)
+  {
+    context->gameObjects.at(i)->destroy();
+  }
 #else
   glutMainLoop();
 
@@ -458,7 +548,9 @@ void Application::quit()
 {
   context->running = false;
 
+#ifdef USE_GLUT
   glutLeaveMainLoop();
+#endif
 }
 
 void Application::loadLevel()
@@ -473,20 +565,17 @@ void Application::loadLevel()
     }
   }
 
-  for(size_t i = 0; i < context->objects.size(); i++)
-  {
-    if(context->objects.at(i)->destroyOnLoad == true)
-    {
-      context->objects.erase(context->objects.begin() + i);
-      context->paths.erase(context->paths.begin() + i);
-      i--;
-    }
-  }
+  context->resourceCache->sweepDestroyOnLoad();
+
+  StaticBatchingUtility::sweepDestroyOnLoad();
 
   for(size_t i = 0; i < context->gameObjects.size(); i++)
   {
     context->gameObjects.at(i)->levelWasLoaded();
   }
+
+  // Objects flagged static while the level was set up can now be merged
+  StaticBatchingUtility::combine();
 }
 
 void Application::loadLevel(std::string path)
@@ -549,6 +638,10 @@ void Application::display()
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   glViewport(0, 0, Screen::getWidth(), Screen::getHeight());
 
+  Profiler::beginSample("Transforms");
+  context->transformStore->updateAll();
+  Profiler::endSample();
+
   for(size_t h = 0; h < Camera::getAllCameras().size(); h++)
   {
     if(Camera::getAllCameras().at(h)->getGameObject()->getActive() == false)
@@ -568,6 +661,18 @@ void Application::display()
     glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    // obtain left-handed coordinate system by multiplying a negative Z scale on ModelView matrix
+    Matrix4x4 projectionMat = Camera::getCurrent()->getProjectionMatrix();
+
+    Matrix4x4 viewMat = Matrix4x4::getIdentity().scale(Vector3(1, 1, -1)) *
+      Camera::getCurrent()->getGameObject()->getTransform()->getWorldToLocalMatrix();
+
+    Camera::getCurrent()->frustum.extract(projectionMat * viewMat);
+    Camera::getCurrent()->visibleCount = 0;
+    Camera::getCurrent()->culledCount = 0;
+
+    Profiler::beginSample("Render");
+
     for(size_t i = 0; i < context->gameObjects.size(); i++)
     {
       if((Camera::getCurrent()->getCullMask() & context->gameObjects.at(i)->getLayer()) !=
@@ -576,31 +681,56 @@ void Application::display()
         continue;
       }
 
+      Profiler::beginObjectSample(context->gameObjects.at(i).get());
       context->gameObjects.at(i)->render();
+      Profiler::endObjectSample();
     }
 
+    Profiler::endSample();
+    Profiler::beginSample("RenderQueue");
+    context->renderQueue->flush(projectionMat, viewMat);
+    Profiler::endSample();
+
     if(Camera::getCurrent()->targetTexture.valid())
     {
       RenderTexture::setActive(NULL);
     }
   }
 
+  Profiler::beginSample("PostRender");
+
   for(size_t i = 0; i < context->gameObjects.size(); i++)
   {
+    Profiler::beginObjectSample(context->gameObjects.at(i).get());
     context->gameObjects.at(i)->postRender();
+    Profiler::endObjectSample();
   }
 
+  Profiler::endSample();
+  Profiler::beginSample("Gui");
+  context->guiDrawList->begin();
+
   for(size_t i = 0; i < context->gameObjects.size(); i++)
   {
+    Profiler::beginObjectSample(context->gameObjects.at(i).get());
     context->gameObjects.at(i)->gui();
+    Profiler::endObjectSample();
   }
 
+  context->guiDrawList->end();
+  context->textLayoutCache->sweepUnused();
+
+  Profiler::endSample();
+  Profiler::beginSample("SwapBuffers");
+
 #ifdef USE_SDL
   SDL_GL_SwapBuffers();
-#else
+#elif defined(USE_GLUT)
   glutSwapBuffers();
 #endif
 
+  Profiler::endSample();
+
   Input::downKeys.clear();
   Input::upKeys.clear();
   //Input::downMouseButtons.clear();
@@ -612,6 +742,8 @@ void Application::display()
     context->levelChange = "";
     loadLevel();
   }
+
+  Profiler::endFrame();
 }
 
 void Application::idle()
@@ -637,11 +769,30 @@ void Application::idle()
   lastTime = glutGet(GLUT_ELAPSED_TIME);
 #endif
 
+#ifdef USE_HEADLESS
+  // No display to pace against so each tick advances by exactly one step.
+  Time::deltaTime = Time::getFixedDeltaTime();
+#endif
+
+  Profiler::beginFrame();
+  Profiler::beginSample("AsyncLoad");
+  context->asyncLoader->update();
+  Profiler::endSample();
+  Profiler::beginSample("Update");
+
   for(size_t i = 0; i < context->gameObjects.size(); i++)
   {
+    Profiler::beginObjectSample(context->gameObjects.at(i).get());
     context->gameObjects.at(i)->update();
+    Profiler::endObjectSample();
   }
 
+  Profiler::endSample();
+
+  // Runs before the sweep below so batches dissolved this frame are
+  // removed along with the objects that invalidated them.
+  StaticBatchingUtility::update();
+
   for(size_t i = 0; i < context->gameObjects.size(); i++)
   {
     if(context->gameObjects.at(i)->destroyed == true)
@@ -660,6 +811,7 @@ void Application::idle()
   Input::upMouseButtons.clear();
 
   context->graphicsCache->sweepUnused();
+  context->resourceCache->trim();
 }
 
 void Application::motion(int x, int y)
@@ -675,6 +827,9 @@ void Application::mouse(int button, int state, int x, int y)
 #endif
 #ifdef USE_GLUT
   if(state == GLUT_DOWN)
+#endif
+#ifdef USE_HEADLESS
+  if(state == 0)
 #endif
   {
     for(size_t i = 0; i < Input::mouseButtons.size(); i++)
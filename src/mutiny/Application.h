@@ -2,6 +2,15 @@
 #define MUTINY_ENGINE_APPLICATION_H
 
 #include "internal/platform.h"
+#include "internal/ObjectList.h"
+#include "internal/TransformStore.h"
+#include "internal/RenderQueue.h"
+#include "internal/GuiDrawList.h"
+#include "internal/TextLayoutCache.h"
+#include "internal/TextureAtlas.h"
+#include "internal/AsyncLoader.h"
+#include "internal/ResourceCache.h"
+#include "internal/ResourceIndex.h"
 #include "Object.h"
 #include "ref.h"
 #include "Matrix4x4.h"
@@ -19,6 +28,11 @@
 #include <vector>
 #include <string>
 
+namespace gl
+{
+  class Uint;
+}
+
 namespace mutiny
 {
 
@@ -32,6 +46,7 @@ class Camera;
 class Gui;
 class Graphics;
 class Material;
+class Shader;
 class RenderTexture;
 class Screen;
 class Application;
@@ -42,6 +57,9 @@ class GuiSkin;
 class Texture2d;
 class GraphicsCache;
 class Texture2d;
+class Transform;
+class StaticBatchingUtility;
+class StaticBatch;
 
 struct Context
 {
@@ -58,22 +76,31 @@ struct Context
   std::string dataPath;
   std::string engineDataPath;
   std::vector<shared<GameObject> > gameObjects;
+  std::vector<shared<internal::ObjectListBase> > objectLists;
+  shared<internal::TransformStore> transformStore;
 
   int argc;
   std::vector<std::string> argv;
 
   // Resources
-  std::vector<std::string> paths;
-  std::vector<shared<Object> > objects;
+  shared<internal::ResourceCache> resourceCache;
+  shared<internal::ResourceIndex> resourceIndex;
+  shared<internal::AsyncLoader> asyncLoader;
 
   // Graphics
   ref<Material> defaultMaterial;
   ref<RenderTexture> renderTarget;
   ref<Mesh> tempMesh; // TODO: For?
   shared<GraphicsCache> graphicsCache;
+  shared<internal::RenderQueue> renderQueue;
+  shared<gl::Uint> instanceBufferId;
+  bool vertexArrays;
+  bool instancing;
+  std::vector<shared<StaticBatch> > staticBatches;
 
   // Material
   ref<Material> currentMaterial;
+  ref<Shader> currentShader;
   ref<Material> guiMaterial;
   ref<Material> particleMaterial;
   shared<Material> meshNormalTextureMaterial;
@@ -82,10 +109,13 @@ struct Context
   // GUI
   ref<GuiSkin> currentGuiSkin;
   shared<GuiSkin> defaultGuiSkin;
+  shared<internal::GuiDrawList> guiDrawList;
+  shared<internal::TextLayoutCache> textLayoutCache;
   Matrix4x4 matrix;
 
   // Texture2d
   shared<Texture2d> defaultTexture;
+  std::vector<shared<internal::TextureAtlas> > atlases;
 
   // Camera
   std::vector<ref<Camera> > allCameras;
@@ -108,9 +138,15 @@ class Application
   friend class mutiny::engine::Material;
   friend class mutiny::engine::RenderTexture;
   friend class mutiny::engine::Screen;
+  friend class mutiny::engine::Mesh;
   friend class mutiny::engine::MeshRenderer;
   friend class mutiny::engine::ParticleRenderer;
   friend class mutiny::engine::Texture2d;
+  friend class mutiny::engine::Shader;
+  friend class mutiny::engine::Transform;
+  friend class mutiny::engine::StaticBatchingUtility;
+  friend class mutiny::engine::internal::GuiDrawList;
+  friend class mutiny::engine::internal::TextureAtlas;
 
 public:
   static void init(int argc, char* argv[]);
@@ -131,6 +167,7 @@ private:
   static void loadLevel();
   static void loop();
   static void setupPaths();
+  static void detectCapabilities();
   static bool isValidPrefix(std::string path, std::string basename);
   static std::vector<shared<GameObject> >& getGameObjects();
 
@@ -3,10 +3,10 @@
 #include "internal/platform.h"
 #include "Debug.h"
 
-#include <vorbis/vorbisfile.h>
-#include <AL/al.h>
-
 #ifdef USE_OPENAL
+  #include <vorbis/vorbisfile.h>
+  #include <AL/al.h>
+
   #define BUFFER_SIZE 32768 // 32 KB buffers
 #endif
 
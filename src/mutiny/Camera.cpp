@@ -71,6 +71,8 @@ void Camera::onAwake()
   nearClipPlane = 0.3f;
   farClipPlane = 1000.0f;
   cullMask = 1 << 0;
+  visibleCount = 0;
+  culledCount = 0;
 
   backgroundColor = Color(49.0f / 255.0f, 77.0f / 255.0f, 121.0f / 255.0f, 1.0f);
 }
@@ -85,6 +87,16 @@ int Camera::getCullMask()
   return cullMask;
 }
 
+int Camera::getVisibleCount()
+{
+  return visibleCount;
+}
+
+int Camera::getCulledCount()
+{
+  return culledCount;
+}
+
 void Camera::setTargetTexture(ref<RenderTexture> targetTexture)
 {
   this->targetTexture = targetTexture;
@@ -4,6 +4,7 @@
 #include "Behaviour.h"
 #include "Matrix4x4.h"
 #include "Color.h"
+#include "internal/Frustum.h"
 
 #include <memory>
 #include <vector>
@@ -16,10 +17,12 @@ namespace engine
 
 class Application;
 class RenderTexture;
+class MeshRenderer;
 
 class Camera : public Behaviour
 {
   friend class mutiny::engine::Application;
+  friend class mutiny::engine::MeshRenderer;
 
 public:
   static ref<Camera> getMain();
@@ -37,6 +40,8 @@ public:
   Color getBackgroundColor();
   int getCullMask();
   void setCullMask(int cullMask);
+  int getVisibleCount();
+  int getCulledCount();
 
 private:
   Color backgroundColor;
@@ -48,6 +53,9 @@ private:
   Matrix4x4* projectionMatrix;
   ref<RenderTexture> targetTexture;
   int cullMask;
+  internal::Frustum frustum;
+  int visibleCount;
+  int culledCount;
 
   virtual void onAwake();
   virtual void onStart();
@@ -46,7 +46,7 @@ void CharacterController::update()
 {
   grounded = false;
 
-  std::vector<ref<MeshCollider> > collidableObjects = GameObject::findObjectsOfType<MeshCollider>();
+  GameObject::findObjectsOfType<MeshCollider>(collidableObjects);
 
   for(size_t i = 0; i < collidableObjects.size(); i++)
   {
@@ -74,10 +74,7 @@ void CharacterController::checkCollision(ref<MeshCollider> collider)
   // If we set position to 0, 0, then we need to make the characters bounds box move the same way
   // (minus the mesh's position) so that it doesn't get closer.
 
-  Matrix4x4 mat = Matrix4x4::getTrs(collider->getGameObject()->getTransform()->getPosition(),
-                          collider->getGameObject()->getTransform()->getRotation(),
-                          Vector3(1, 1, 1));
-  mat = mat.inverse();
+  Matrix4x4 mat = collider->getGameObject()->getTransform()->getWorldToLocalMatrix();
 
   Vector3 relPos = mat * pos;
   Vector3 extents = bounds.extents;
@@ -87,24 +84,29 @@ void CharacterController::checkCollision(ref<MeshCollider> collider)
   Collision collision;
   //collision.relativeVelocity = frameMoveSpeed;
 
-  for(size_t v = 0; v < vertices.size(); v+=3)
+  for(size_t s = 0; s < mesh->getSubmeshCount(); s++)
   {
-    Vector3 a = vertices.at(v);
-    Vector3 b = vertices.at(v+1);
-    Vector3 c = vertices.at(v+2);
+    std::vector<int>& triangles = mesh->getTriangles(s);
 
-    if(colliding(relPos, extents, a, b, c) == true)
+    for(size_t v = 0; v < triangles.size(); v+=3)
     {
-      ContactPoint contact;
+      Vector3 a = vertices.at(triangles.at(v));
+      Vector3 b = vertices.at(triangles.at(v+1));
+      Vector3 c = vertices.at(triangles.at(v+2));
+
+      if(colliding(relPos, extents, a, b, c) == true)
+      {
+        ContactPoint contact;
 
-      contact.normal = findNormal(a, b, c);
-      contact.thisCollider = this;
-      contact.otherCollider = collider.get();
-      contact.a = a;
-      contact.b = b;
-      contact.c = c;
+        contact.normal = findNormal(a, b, c);
+        contact.thisCollider = this;
+        contact.otherCollider = collider.get();
+        contact.a = a;
+        contact.b = b;
+        contact.c = c;
 
-      collision.contacts.push_back(contact);
+        collision.contacts.push_back(contact);
+      }
     }
   }
 
@@ -126,24 +128,29 @@ void CharacterController::checkCollision(ref<MeshCollider> collider)
   stepExtents.z = stepExtents.z / 2.0f;
   stepExtents.y = stepExtents.y + 0.01f;
 
-  for(size_t v = 0; v < vertices.size(); v+=3)
+  for(size_t s = 0; s < mesh->getSubmeshCount(); s++)
   {
-    Vector3 a = vertices.at(v);
-    Vector3 b = vertices.at(v+1);
-    Vector3 c = vertices.at(v+2);
+    std::vector<int>& triangles = mesh->getTriangles(s);
 
-    if(colliding(relPos, stepExtents, a, b, c) == true)
+    for(size_t v = 0; v < triangles.size(); v+=3)
     {
-      ContactPoint contact;
+      Vector3 a = vertices.at(triangles.at(v));
+      Vector3 b = vertices.at(triangles.at(v+1));
+      Vector3 c = vertices.at(triangles.at(v+2));
 
-      contact.normal = findNormal(a, b, c);
-      contact.thisCollider = this;
-      contact.otherCollider = collider.get();
-      contact.a = a;
-      contact.b = b;
-      contact.c = c;
+      if(colliding(relPos, stepExtents, a, b, c) == true)
+      {
+        ContactPoint contact;
+
+        contact.normal = findNormal(a, b, c);
+        contact.thisCollider = this;
+        contact.otherCollider = collider.get();
+        contact.a = a;
+        contact.b = b;
+        contact.c = c;
 
-      stepCollision.contacts.push_back(contact);
+        stepCollision.contacts.push_back(contact);
+      }
     }
   }
 
@@ -27,6 +27,7 @@ public:
 
 private:
   bool grounded;
+  std::vector<ref<MeshCollider> > collidableObjects;
 
   virtual void awake();
   virtual void update();
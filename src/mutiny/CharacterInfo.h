@@ -15,8 +15,9 @@ public:
   char index;
   Rect uv;
   Rect vert;
+  float advance;
 
-  int getWidth() { return uv.width; }
+  int getWidth() { return advance; }
 
 };
 
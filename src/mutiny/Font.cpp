@@ -56,25 +56,72 @@ ref<Font> Font::load(std::string path)
       info.uv.y = ((float)y * charSize.y) / (float)font->texture->getHeight();
       info.uv.width = ((float)x * charSize.x + charSize.x) / (float)font->texture->getWidth();
       info.uv.height = ((float)y * charSize.y + charSize.y) / (float)font->texture->getHeight();
+      info.advance = charSize.x;
       font->characterInfo.push_back(info);
     }
   }
 
+  font->glyphs.resize(256, -1);
+
+  for(int i = 0; i < font->characterInfo.size(); i++)
+  {
+    font->glyphs.at((unsigned char)font->characterInfo.at(i).index) = i;
+  }
+
+  font->loadMetrics(path + ".txt");
+
   return font;
 }
 
-bool Font::getCharacterInfo(char character, CharacterInfo& characterInfo)
+void Font::loadMetrics(std::string path)
 {
-  for(int i = 0; i < this->characterInfo.size(); i++)
+  std::ifstream file(path.c_str());
+  int character = 0;
+  float advance = 0;
+
+  // Optional and one "<character code> <advance>" pair per line. Anything
+  // not listed keeps the full cell width so fonts stay monospaced unless
+  // told otherwise.
+  while(file >> character >> advance)
   {
-    if(this->characterInfo.at(i).index == character)
+    if(character < 0 || character > 255)
     {
-      characterInfo = this->characterInfo.at(i);
-      return true;
+      continue;
     }
+
+    CharacterInfo* info = getGlyph((char)character);
+
+    if(info != NULL)
+    {
+      info->advance = advance;
+    }
+  }
+}
+
+CharacterInfo* Font::getGlyph(char character)
+{
+  int index = glyphs.at((unsigned char)character);
+
+  if(index == -1)
+  {
+    return NULL;
   }
 
-  return false;
+  return &this->characterInfo.at(index);
+}
+
+bool Font::getCharacterInfo(char character, CharacterInfo& characterInfo)
+{
+  CharacterInfo* info = getGlyph(character);
+
+  if(info == NULL)
+  {
+    return false;
+  }
+
+  characterInfo = *info;
+
+  return true;
 }
 
 }
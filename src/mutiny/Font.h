@@ -18,10 +18,16 @@ class Texture2d;
 class Resources;
 class Gui;
 
+namespace internal
+{
+  class TextLayoutCache;
+}
+
 class Font : public Object
 {
   friend class mutiny::engine::Resources;
   friend class mutiny::engine::Gui;
+  friend class mutiny::engine::internal::TextLayoutCache;
 
 public:
   bool getCharacterInfo(char character, CharacterInfo& characterInfo);
@@ -29,9 +35,16 @@ public:
 private:
   static ref<Font> load(std::string path);
 
+  void loadMetrics(std::string path);
+  CharacterInfo* getGlyph(char character);
+
   shared<Texture2d> texture;
   std::vector<CharacterInfo> characterInfo;
 
+  // Index into characterInfo for every possible char, -1 where the font
+  // has no glyph
+  std::vector<int> glyphs;
+
 };
 
 }
@@ -6,6 +6,7 @@
 #include "Resources.h"
 #include "Transform.h"
 #include "Debug.h"
+#include "Profiler.h"
 
 #include "MeshCollider.h"
 #include "buccaneer/buccaneer.h"
@@ -51,18 +52,22 @@ ref<GameObject> GameObject::createModel(std::string path)
 GameObject::GameObject(std::string name)
 {
   setName(name);
-  addComponent<Transform>();
+  transform = addComponent<Transform>().get();
   Application::getGameObjects().push_back(shared<GameObject>(this));
+  indexObject(this);
   activeSelf = true;
   layer = 1 << 0;
+  _static = false;
 }
 
 GameObject::GameObject()
 {
-  addComponent<Transform>();
+  transform = addComponent<Transform>().get();
   Application::getGameObjects().push_back(shared<GameObject>(this));
+  indexObject(this);
   activeSelf = true;
   layer = 1 << 0;
+  _static = false;
 }
 
 ref<GameObject> GameObject::create(std::string name)
@@ -97,6 +102,16 @@ int GameObject::getLayer()
   return layer;
 }
 
+void GameObject::setStatic(bool _static)
+{
+  this->_static = _static;
+}
+
+bool GameObject::getStatic()
+{
+  return _static;
+}
+
 void GameObject::awake()
 {
   for(size_t i = 0; i < components.size(); i++)
@@ -115,42 +130,79 @@ void GameObject::start()
 
 void GameObject::update()
 {
+  bool profile = Profiler::detail;
+
   for(size_t i = 0; i < components.size(); i++)
   {
     if(components.at(i)->destroyed == true)
     {
       components.at(i)->destroy();
+
+      if(components.at(i).get() == transform)
+      {
+        transform->release();
+        transform = NULL;
+      }
+
+      unindexObject(components.at(i).get());
       components.erase(components.begin() + i);
+      componentIndex.clear();
       i--;
     }
     else
     {
       components.at(i)->update();
+
+      if(profile == true)
+      {
+        Profiler::sampleComponent(components.at(i).get());
+      }
     }
   }
 }
 
 void GameObject::render()
 {
+  bool profile = Profiler::detail;
+
   for(size_t i = 0; i < components.size(); i++)
   {
     components.at(i)->render();
+
+    if(profile == true)
+    {
+      Profiler::sampleComponent(components.at(i).get());
+    }
   }
 }
 
 void GameObject::postRender()
 {
+  bool profile = Profiler::detail;
+
   for(size_t i = 0; i < components.size(); i++)
   {
     components.at(i)->postRender();
+
+    if(profile == true)
+    {
+      Profiler::sampleComponent(components.at(i).get());
+    }
   }
 }
 
 void GameObject::gui()
 {
+  bool profile = Profiler::detail;
+
   for(size_t i = 0; i < components.size(); i++)
   {
     components.at(i)->gui();
+
+    if(profile == true)
+    {
+      Profiler::sampleComponent(components.at(i).get());
+    }
   }
 }
 
@@ -159,6 +211,40 @@ void GameObject::destroy()
   for(size_t i = 0; i < components.size(); i++)
   {
     components.at(i)->destroy();
+    unindexObject(components.at(i).get());
+  }
+
+  if(transform != NULL)
+  {
+    transform->release();
+  }
+
+  unindexObject(this);
+}
+
+void GameObject::indexObject(Object* object)
+{
+  std::vector<shared<internal::ObjectListBase> >& lists = Application::context->objectLists;
+
+  for(size_t i = 0; i < lists.size(); i++)
+  {
+    if(lists.at(i).get() != NULL)
+    {
+      lists.at(i)->add(object);
+    }
+  }
+}
+
+void GameObject::unindexObject(Object* object)
+{
+  std::vector<shared<internal::ObjectListBase> >& lists = Application::context->objectLists;
+
+  for(size_t i = 0; i < lists.size(); i++)
+  {
+    if(lists.at(i).get() != NULL)
+    {
+      lists.at(i)->remove(object);
+    }
   }
 }
 
@@ -206,7 +292,7 @@ bool GameObject::getActive()
 
 ref<Transform> GameObject::getTransform()
 {
-  return getComponent<Transform>();
+  return transform;
 }
 
 std::string GameObject::getTag()
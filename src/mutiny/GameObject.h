@@ -3,6 +3,7 @@
 
 #include "Component.h"
 #include "Application.h"
+#include "internal/TypeId.h"
 
 #include <memory>
 #include <string>
@@ -30,33 +31,21 @@ public:
   static ref<GameObject> createPrimitive(int primitiveType);
   static ref<GameObject> createModel(std::string path);
 
+  // Returns a copy of the live list kept for T so that objects created or
+  // destroyed while the caller iterates it do not disturb the iteration
   template<class T> static std::vector<ref<T> > findObjectsOfType()
   {
-    std::vector<shared<GameObject> >& gameObjects = Application::getGameObjects();
-    std::vector<ref<T> > objects;
-
-    for(int i = 0; i < gameObjects.size(); i++)
-    {
-      ref<GameObject> gameObject = gameObjects.at(i);
-
-      ref<T> testGameObject =
-        dynamic_cast<T*>(gameObject.get());
-
-      if(testGameObject.valid())
-      {
-        objects.push_back(testGameObject);
-      }
-
-      ref<T> testComponent =
-        dynamic_cast<T*>(gameObject->getComponent<T>().try_get());
+    return getObjectList<T>()->objects;
+  }
 
-      if(testComponent.valid())
-      {
-        objects.push_back(testComponent);
-      }
-    }
+  // Refills the caller's vector with the live list kept for T, reusing its
+  // storage rather than allocating a new copy on every query
+  template<class T> static void findObjectsOfType(std::vector<ref<T> >& objects)
+  {
+    std::vector<ref<T> >& list = getObjectList<T>()->objects;
 
-    return objects;
+    objects.clear();
+    objects.insert(objects.end(), list.begin(), list.end());
   }
 
   static void findGameObjectsWithTag(std::string tag, std::vector<ref<GameObject> >& gameObjects);
@@ -76,6 +65,8 @@ public:
   ref<Transform> getTransform();
   void setTag(std::string tag);
   std::string getTag();
+  void setStatic(bool _static);
+  bool getStatic();
 
   template <class T>
   ref<T> addComponent()
@@ -83,6 +74,8 @@ public:
     shared<T> c(new T());
 
     components.push_back(c);
+    componentIndex.clear();
+    indexObject(c.get());
     c->gameObject = this;
     c->awake();
 
@@ -92,12 +85,35 @@ public:
   template<class T>
   ref<T> getComponent()
   {
-    for(int i = 0; i < components.size(); i++)
+    int id = internal::TypeId::get<T>();
+
+    if(id < (int)componentIndex.size() && componentIndex.at(id) != 0)
+    {
+      if(componentIndex.at(id) < 0)
+      {
+        return ref<T>();
+      }
+
+      return static_cast<T*>(components.at(componentIndex.at(id) - 1).get());
+    }
+
+    // First lookup of this type since the component list last changed. The
+    // result, including a miss, is remembered until it changes again.
+    if(id >= (int)componentIndex.size())
     {
-      ref<T> t = dynamic_cast<T*>(components.at(i).get());
+      componentIndex.resize(id + 1, 0);
+    }
+
+    componentIndex.at(id) = -1;
 
-      if(t.valid())
+    for(size_t i = 0; i < components.size(); i++)
+    {
+      T* t = dynamic_cast<T*>(components.at(i).get());
+
+      if(t != NULL)
       {
+        componentIndex.at(id) = i + 1;
+
         return t;
       }
     }
@@ -107,8 +123,48 @@ public:
 
 private:
   std::vector<shared<Component> > components;
+  std::vector<int> componentIndex;
+  Transform* transform;
+
+  static void indexObject(Object* object);
+  static void unindexObject(Object* object);
+
+  template<class T> static internal::ObjectList<T>* getObjectList()
+  {
+    std::vector<shared<internal::ObjectListBase> >& lists = Application::context->objectLists;
+    int id = internal::TypeId::get<T>();
+
+    if(id >= (int)lists.size())
+    {
+      lists.resize(id + 1);
+    }
+
+    if(lists.at(id).get() == NULL)
+    {
+      // First query for this type so build the list from the scene. From
+      // now on it is maintained as objects are added and removed.
+      std::vector<shared<GameObject> >& gameObjects = Application::getGameObjects();
+      shared<internal::ObjectList<T> > list(new internal::ObjectList<T>());
+
+      for(size_t i = 0; i < gameObjects.size(); i++)
+      {
+        list->add(gameObjects.at(i).get());
+
+        for(size_t j = 0; j < gameObjects.at(i)->components.size(); j++)
+        {
+          list->add(gameObjects.at(i)->components.at(j).get());
+        }
+      }
+
+      lists.at(id) = list;
+    }
+
+    return static_cast<internal::ObjectList<T>*>(lists.at(id).get());
+  }
+
   bool activeSelf;
   int layer;
+  bool _static;
   std::string tag;
 
   virtual void awake();
@@ -13,12 +13,14 @@
 #include "Mesh.h"
 #include "Debug.h"
 
-#include <GL/glew.h>
+#include "internal/glmm.h"
+#include "internal/OpenGl.h"
 
 #include <vector>
 #include <string>
 #include <iostream>
 #include <string>
+#include <cstring>
 
 namespace mutiny
 {
@@ -31,7 +33,10 @@ shared<GraphicsCacheEntry> GraphicsCacheEntry::create()
   shared<GraphicsCacheEntry> rtn;
 
   rtn.reset(new GraphicsCacheEntry());
-  rtn->useCount = 10;
+  rtn->hash = 0;
+  rtn->lastUsed = 0;
+  rtn->prev = NULL;
+  rtn->next = NULL;
 
   return rtn;
 }
@@ -41,15 +46,62 @@ shared<GraphicsCache> GraphicsCache::create()
   shared<GraphicsCache> rtn;
 
   rtn.reset(new GraphicsCache());
+  rtn->head = NULL;
+  rtn->tail = NULL;
+  rtn->capacity = DEFAULT_CAPACITY;
+  rtn->frame = 0;
+  rtn->hits = 0;
+  rtn->misses = 0;
 
   return rtn;
 }
 
-shared<Mesh> GraphicsCache::matchMesh(std::vector<Rect>& rects, std::vector<Rect>& sourceRects)
+static void hashFloat(unsigned int& hash, float value)
 {
-  for(size_t i = 0; i < entries.size(); i++)
+  unsigned char bytes[sizeof(float)];
+
+  // Adding zero folds -0.0f into 0.0f so equal rects hash the same
+  value += 0.0f;
+  memcpy(bytes, &value, sizeof(float));
+
+  for(size_t i = 0; i < sizeof(float); i++)
+  {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+}
+
+unsigned int GraphicsCache::hashRects(std::vector<Rect>& rects, std::vector<Rect>& sourceRects)
+{
+  unsigned int hash = 2166136261u;
+
+  for(size_t i = 0; i < rects.size(); i++)
+  {
+    hashFloat(hash, rects.at(i).x);
+    hashFloat(hash, rects.at(i).y);
+    hashFloat(hash, rects.at(i).width);
+    hashFloat(hash, rects.at(i).height);
+  }
+
+  for(size_t i = 0; i < sourceRects.size(); i++)
   {
-    ref<GraphicsCacheEntry> entry = entries.at(i);
+    hashFloat(hash, sourceRects.at(i).x);
+    hashFloat(hash, sourceRects.at(i).y);
+    hashFloat(hash, sourceRects.at(i).width);
+    hashFloat(hash, sourceRects.at(i).height);
+  }
+
+  return hash;
+}
+
+shared<Mesh> GraphicsCache::matchMesh(std::vector<Rect>& rects, std::vector<Rect>& sourceRects, unsigned int hash)
+{
+  typedef std::multimap<unsigned int, shared<GraphicsCacheEntry> >::iterator Iterator;
+  std::pair<Iterator, Iterator> range = entries.equal_range(hash);
+
+  for(Iterator it = range.first; it != range.second; it++)
+  {
+    GraphicsCacheEntry* entry = it->second.get();
     bool different = false;
 
     if(rects.size() != entry->rects.size() || sourceRects.size() != entry->sourceRects.size())
@@ -59,7 +111,8 @@ shared<Mesh> GraphicsCache::matchMesh(std::vector<Rect>& rects, std::vector<Rect
 
     for(size_t r = 0; r < entry->rects.size(); r++)
     {
-      if(rects.at(r).equals(entry->rects.at(r)) == false)
+      if(rects.at(r).equals(entry->rects.at(r)) == false ||
+        sourceRects.at(r).equals(entry->sourceRects.at(r)) == false)
       {
         different = true;
         break;
@@ -71,53 +124,154 @@ shared<Mesh> GraphicsCache::matchMesh(std::vector<Rect>& rects, std::vector<Rect
       continue;
     }
 
-    for(size_t r = 0; r < entry->sourceRects.size(); r++)
-    {
-      if(sourceRects.at(r).equals(entry->sourceRects.at(r)) == false)
-      {
-        different = true;
-        break;
-      }
-    }
+    entry->lastUsed = frame;
+    unlink(entry);
+    link(entry);
+    hits++;
 
-    if(different == true)
-    {
-      continue;
-    }
-
-    entry->useCount = 10;
     return entry->mesh;
   }
 
+  misses++;
+
   return shared<Mesh>();
 }
 
-void GraphicsCache::addMesh(std::vector<Rect>& rects, std::vector<Rect>& sourceRects, shared<Mesh> mesh)
+void GraphicsCache::addMesh(std::vector<Rect>& rects, std::vector<Rect>& sourceRects, unsigned int hash, shared<Mesh> mesh)
 {
+  while(tail != NULL && (int)entries.size() >= capacity)
+  {
+    evict(tail);
+  }
+
+  if(capacity < 1)
+  {
+    return;
+  }
+
   shared<GraphicsCacheEntry> entry = GraphicsCacheEntry::create();
   entry->rects = rects;
   entry->sourceRects = sourceRects;
   entry->mesh = mesh;
-  entries.push_back(entry);
+  entry->hash = hash;
+  entry->lastUsed = frame;
+  link(entry.get());
+  entries.insert(std::make_pair(hash, entry));
 }
 
 void GraphicsCache::sweepUnused()
 {
-  for(size_t i = 0; i < entries.size(); i++)
+  frame++;
+
+  // The list is ordered by last use so only the stale tail needs visiting
+  while(tail != NULL && frame - tail->lastUsed >= MAX_UNUSED_FRAMES)
+  {
+    evict(tail);
+  }
+}
+
+void GraphicsCache::link(GraphicsCacheEntry* entry)
+{
+  entry->prev = NULL;
+  entry->next = head;
+
+  if(head != NULL)
+  {
+    head->prev = entry;
+  }
+
+  head = entry;
+
+  if(tail == NULL)
+  {
+    tail = entry;
+  }
+}
+
+void GraphicsCache::unlink(GraphicsCacheEntry* entry)
+{
+  if(entry->prev != NULL)
+  {
+    entry->prev->next = entry->next;
+  }
+  else
+  {
+    head = entry->next;
+  }
+
+  if(entry->next != NULL)
+  {
+    entry->next->prev = entry->prev;
+  }
+  else
   {
-    entries.at(i)->useCount--;
+    tail = entry->prev;
+  }
+
+  entry->prev = NULL;
+  entry->next = NULL;
+}
+
+void GraphicsCache::evict(GraphicsCacheEntry* entry)
+{
+  typedef std::multimap<unsigned int, shared<GraphicsCacheEntry> >::iterator Iterator;
+  std::pair<Iterator, Iterator> range = entries.equal_range(entry->hash);
+
+  unlink(entry);
 
-    if(entries.at(i)->useCount <= 0)
+  for(Iterator it = range.first; it != range.second; it++)
+  {
+    if(it->second.get() == entry)
     {
-      entries.erase(entries.begin() + i);
-      i--;
+      entries.erase(it);
+      break;
     }
   }
 }
 
+void Graphics::setCacheCapacity(int capacity)
+{
+  ref<GraphicsCache> cache = Application::context->graphicsCache;
+
+  cache->capacity = capacity;
+
+  while(cache->tail != NULL && (int)cache->entries.size() > capacity)
+  {
+    cache->evict(cache->tail);
+  }
+}
+
+int Graphics::getCacheCapacity()
+{
+  return Application::context->graphicsCache->capacity;
+}
+
+int Graphics::getCacheSize()
+{
+  return Application::context->graphicsCache->entries.size();
+}
+
+int Graphics::getCacheHits()
+{
+  return Application::context->graphicsCache->hits;
+}
+
+int Graphics::getCacheMisses()
+{
+  return Application::context->graphicsCache->misses;
+}
+
+void Graphics::resetCacheStats()
+{
+  Application::context->graphicsCache->hits = 0;
+  Application::context->graphicsCache->misses = 0;
+}
+
 // TODO: Does this need to be re-enabled every draw?
 void Graphics::setRenderTarget(ref<RenderTexture> renderTarget)
 {
+  // Queued Gui quads belong to the target that was current when drawn
+  Application::context->guiDrawList->flush();
   Application::context->renderTarget = renderTarget;
 }
 
@@ -142,62 +296,84 @@ void Graphics::drawTextureBatch(std::vector<Rect> rects, ref<Texture> texture, s
   std::vector<Color> colors;
   std::vector<int> triangles;
 
-  if(material.expired())
+  if(texture.expired())
   {
-    // TODO: Use a unique material with MVP set
-    //material = Application::context->defaultMaterial;
-    material = Application::context->guiMaterial.get();
-    //material = Material::guiMaterial;
-    material->setMatrix("in_Projection", Matrix4x4::ortho(0, Screen::getWidth(), Screen::getHeight(), 0, -1, 1));
-    material->setMatrix("in_View", Matrix4x4::getIdentity());
-    material->setMatrix("in_Model", Matrix4x4::getIdentity());
+    Debug::logWarning("Texture is null");
+    return;
   }
 
-  if(texture.expired())
+  // Anything using the Gui material is appended to the frame's draw list,
+  // only the Gui itself applies its matrix.
+  if(material.expired())
   {
-    Debug::logWarning("Texture is null");
+    Application::context->guiDrawList->add(texture, rects, sourceRects,
+      Matrix4x4::getIdentity());
+
     return;
   }
+  else if(material.get() == Application::context->guiMaterial.get())
+  {
+    Application::context->guiDrawList->add(texture, rects, sourceRects,
+      Gui::getMatrix());
 
-  for(size_t i = 0; i < rects.size(); i++)
+    return;
+  }
+
+  // A custom material draws now so queued quads must go out first to keep
+  // the order they were drawn in
+  Application::context->guiDrawList->flush();
+
+  Rect& uvRect = texture->uvRect;
+
+  for(size_t i = 0; i < sourceRects.size(); i++)
   {
-    float x = (float)rects.at(i).x;
-    float y = (float)rects.at(i).y;
-    float xw = (float)rects.at(i).x + (float)rects.at(i).width;
-    float yh = (float)rects.at(i).y + (float)rects.at(i).height;
-
-    triangles.push_back((i*6) + 0);
-    triangles.push_back((i*6) + 1);
-    triangles.push_back((i*6) + 2);
-    triangles.push_back((i*6) + 3);
-    triangles.push_back((i*6) + 4);
-    triangles.push_back((i*6) + 5);
-
-    vertices.push_back(Vector3(x, y, 0));
-    vertices.push_back(Vector3(x, yh, 0));
-    vertices.push_back(Vector3(xw, yh));
-    vertices.push_back(Vector3(xw, yh));
-    vertices.push_back(Vector3(xw, y));
-    vertices.push_back(Vector3(x, y));
-
-    uv.push_back(Vector2(sourceRects.at(i).x, sourceRects.at(i).y));
-    uv.push_back(Vector2(sourceRects.at(i).x, sourceRects.at(i).height));
-    uv.push_back(Vector2(sourceRects.at(i).width, sourceRects.at(i).height));
-    uv.push_back(Vector2(sourceRects.at(i).width, sourceRects.at(i).height));
-    uv.push_back(Vector2(sourceRects.at(i).width, sourceRects.at(i).y));
-    uv.push_back(Vector2(sourceRects.at(i).x, sourceRects.at(i).y));
-  }  
+    Rect& s = sourceRects.at(i);
+
+    s = Rect(uvRect.x + s.x * uvRect.width, uvRect.y + s.y * uvRect.height,
+      uvRect.x + s.width * uvRect.width, uvRect.y + s.height * uvRect.height);
+  }
+
+  ref<GraphicsCache> cache = Application::context->graphicsCache;
+  unsigned int hash = GraphicsCache::hashRects(rects, sourceRects);
+  shared<Mesh> mesh = cache->matchMesh(rects, sourceRects, hash);
 
   //if(Application::context->tempMesh.expired())
   //{
   //  Application::context->tempMesh = new Mesh();
   //}
 
-  ref<GraphicsCache> cache = Application::context->graphicsCache;
-  shared<Mesh> mesh = cache->matchMesh(rects, sourceRects);
-
+  // Geometry only needs building when no cached mesh matches
   if(mesh.get() == NULL)
   {
+    for(size_t i = 0; i < rects.size(); i++)
+    {
+      float x = (float)rects.at(i).x;
+      float y = (float)rects.at(i).y;
+      float xw = (float)rects.at(i).x + (float)rects.at(i).width;
+      float yh = (float)rects.at(i).y + (float)rects.at(i).height;
+
+      triangles.push_back((i*6) + 0);
+      triangles.push_back((i*6) + 1);
+      triangles.push_back((i*6) + 2);
+      triangles.push_back((i*6) + 3);
+      triangles.push_back((i*6) + 4);
+      triangles.push_back((i*6) + 5);
+
+      vertices.push_back(Vector3(x, y, 0));
+      vertices.push_back(Vector3(x, yh, 0));
+      vertices.push_back(Vector3(xw, yh));
+      vertices.push_back(Vector3(xw, yh));
+      vertices.push_back(Vector3(xw, y));
+      vertices.push_back(Vector3(x, y));
+
+      uv.push_back(Vector2(sourceRects.at(i).x, sourceRects.at(i).y));
+      uv.push_back(Vector2(sourceRects.at(i).x, sourceRects.at(i).height));
+      uv.push_back(Vector2(sourceRects.at(i).width, sourceRects.at(i).height));
+      uv.push_back(Vector2(sourceRects.at(i).width, sourceRects.at(i).height));
+      uv.push_back(Vector2(sourceRects.at(i).width, sourceRects.at(i).y));
+      uv.push_back(Vector2(sourceRects.at(i).x, sourceRects.at(i).y));
+    }
+
     //mesh = Application::context->tempMesh;
     mesh.reset(new Mesh());
     mesh->setVertices(vertices);
@@ -205,7 +381,7 @@ void Graphics::drawTextureBatch(std::vector<Rect> rects, ref<Texture> texture, s
     //mesh.setColors(colors);
 
     mesh->setTriangles(triangles, 0);
-    cache->addMesh(rects, sourceRects, mesh);
+    cache->addMesh(rects, sourceRects, hash, mesh);
   }
 
   material->setMainTexture(texture);
@@ -276,11 +452,208 @@ void Graphics::drawTexture(Rect rect, ref<Texture> texture, ref<Material> materi
   drawTexture(rect, texture, Rect(0, 0, 1, 1), material);
 }
 
+// Each instance is a model matrix followed by a normal matrix
+static const int INSTANCE_FLOATS = 32;
+
+static void bindInstanceAttribute(GLint location, int offset)
+{
+  if(location == -1)
+  {
+    return;
+  }
+
+  // A mat4 attribute occupies four consecutive locations, one per column
+  for(int c = 0; c < 4; c++)
+  {
+    glVertexAttribPointer(location + c, 4, GL_FLOAT, GL_FALSE,
+      INSTANCE_FLOATS * sizeof(GLfloat), (GLvoid*)((offset + c * 4) * sizeof(GLfloat)));
+
+    glEnableVertexAttribArray(location + c);
+    glVertexAttribDivisor(location + c, 1);
+  }
+}
+
+static void unbindInstanceAttribute(GLint location)
+{
+  if(location == -1)
+  {
+    return;
+  }
+
+  for(int c = 0; c < 4; c++)
+  {
+    glVertexAttribDivisor(location + c, 0);
+    glDisableVertexAttribArray(location + c);
+  }
+}
+
+static void setInstanceAttribute(GLint location, const float* matrix)
+{
+  if(location == -1)
+  {
+    return;
+  }
+
+  for(int c = 0; c < 4; c++)
+  {
+    glVertexAttrib4fv(location + c, matrix + c * 4);
+  }
+}
+
+void Graphics::drawMeshInstanced(ref<Mesh> mesh, int submesh, ref<Material> material, std::vector<Matrix4x4>& matrices)
+{
+  static int viewId = Shader::propertyToId("in_View");
+
+  if(mesh.expired())
+  {
+    Debug::log("Mesh is null");
+    return;
+  }
+
+  if(submesh >= mesh->getSubmeshCount())
+  {
+    Debug::log("Invalid material index");
+    return;
+  }
+
+  if(material.expired())
+  {
+    Debug::log("Material is NULL");
+    return;
+  }
+
+  if(matrices.size() < 1)
+  {
+    return;
+  }
+
+  // Shaders without instance attributes still work, one draw per matrix
+  if(material->instanceModelId == -1)
+  {
+    for(int j = 0; j < material->getPassCount(); j++)
+    {
+      material->setPass(j, material);
+
+      for(size_t i = 0; i < matrices.size(); i++)
+      {
+        drawMeshNow(mesh, matrices.at(i), submesh);
+      }
+    }
+
+    return;
+  }
+
+  std::vector<float> instances(matrices.size() * INSTANCE_FLOATS);
+  Matrix4x4 viewMat = material->getMatrix(viewId);
+  ref<Camera> camera = Camera::getCurrent();
+
+  // The material may have last been drawn by another camera so the view
+  // is taken from the one rendering now and set for the shader to match
+  if(camera.valid())
+  {
+    viewMat = Matrix4x4::getIdentity().scale(Vector3(1, 1, -1)) *
+      camera->getGameObject()->getTransform()->getWorldToLocalMatrix();
+
+    material->setMatrix(viewId, viewMat);
+  }
+
+  for(size_t i = 0; i < matrices.size(); i++)
+  {
+    float* instance = &instances[i * INSTANCE_FLOATS];
+    memcpy(instance, matrices.at(i).getValue(), 16 * sizeof(float));
+
+    if(material->instanceNormalMatrixId != -1)
+    {
+      Matrix4x4 normalMat = (viewMat * matrices.at(i).inverse()).transpose();
+      memcpy(instance + 16, normalMat.getValue(), 16 * sizeof(float));
+    }
+  }
+
+  for(int j = 0; j < material->getPassCount(); j++)
+  {
+    material->setPass(j, material);
+    drawMeshInstances(mesh, submesh, &instances[0], matrices.size());
+  }
+}
+
+void Graphics::drawMeshInstances(ref<Mesh> mesh, int submesh, const float* instances, int count)
+{
+  Material* material = Application::context->currentMaterial.get();
+  GLint positionAttribId = material->positionId;
+  GLint normalAttribId = material->normalId;
+  GLint uvAttribId = material->uvId;
+
+  mesh->prepare();
+
+  int indexSize = sizeof(GLushort);
+
+  if(mesh->indexType == GL_UNSIGNED_INT)
+  {
+    indexSize = sizeof(GLuint);
+  }
+
+  GLsizei indexCount = mesh->submeshCounts.at(submesh);
+  GLvoid* offset = (GLvoid*)(size_t)(mesh->submeshOffsets.at(submesh) * indexSize);
+  GLuint vertexArrayId = mesh->getVertexArray(positionAttribId, normalAttribId, uvAttribId);
+
+  if(vertexArrayId != 0)
+  {
+    glBindVertexArray(vertexArrayId);
+  }
+  else
+  {
+    mesh->bindAttributes(positionAttribId, normalAttribId, uvAttribId);
+  }
+
+  if(Application::context->instancing == true)
+  {
+    if(Application::context->instanceBufferId.get() == NULL)
+    {
+      Application::context->instanceBufferId = gl::Uint::genBuffer();
+    }
+
+    // The buffer is respecified every draw so the driver can hand out fresh
+    // storage instead of waiting on the previous draw to finish with it
+    glBindBuffer(GL_ARRAY_BUFFER, Application::context->instanceBufferId->getGLuint());
+    glBufferData(GL_ARRAY_BUFFER, count * INSTANCE_FLOATS * sizeof(GLfloat), instances, GL_STREAM_DRAW);
+    bindInstanceAttribute(material->instanceModelId, 0);
+    bindInstanceAttribute(material->instanceNormalMatrixId, 16);
+
+    glDrawElementsInstanced(GL_TRIANGLES, indexCount, mesh->indexType, offset, count);
+
+    unbindInstanceAttribute(material->instanceModelId);
+    unbindInstanceAttribute(material->instanceNormalMatrixId);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+  else
+  {
+    // Without instancing support the matrices are fed as constant attributes
+    for(int i = 0; i < count; i++)
+    {
+      setInstanceAttribute(material->instanceModelId, instances + i * INSTANCE_FLOATS);
+      setInstanceAttribute(material->instanceNormalMatrixId, instances + i * INSTANCE_FLOATS + 16);
+      glDrawElements(GL_TRIANGLES, indexCount, mesh->indexType, offset);
+    }
+  }
+
+  if(vertexArrayId != 0)
+  {
+    glBindVertexArray(0);
+  }
+  else
+  {
+    mesh->unbindAttributes(positionAttribId, normalAttribId, uvAttribId);
+  }
+}
+
 void Graphics::drawMeshNow(ref<Mesh> mesh, Matrix4x4 matrix, int materialIndex)
 {
   ref<Material> material;
   ref<Shader> shader;
 
+  // Gui quads queued before this call have to reach the target first
+  Application::context->guiDrawList->flush();
+
   if(mesh.expired())
   {
     Debug::log("Mesh is null");
@@ -301,7 +674,8 @@ void Graphics::drawMeshNow(ref<Mesh> mesh, Matrix4x4 matrix, int materialIndex)
     return;
   }
 
-  material->setMatrix("in_Model", matrix);
+  static int modelId = Shader::propertyToId("in_Model");
+  material->setMatrix(modelId, matrix);
 
   shader = material->getShader();
 
@@ -311,13 +685,25 @@ void Graphics::drawMeshNow(ref<Mesh> mesh, Matrix4x4 matrix, int materialIndex)
     return;
   }
 
-  GLuint modelUniformId = material->modelUniformId;
-
-  if(modelUniformId != -1)
+  if(material->instanceModelId != -1)
   {
-    glUniformMatrix4fv(modelUniformId, 1, GL_FALSE, matrix.getValue());
+    static int viewId = Shader::propertyToId("in_View");
+    float instance[INSTANCE_FLOATS] = { 0 };
+    memcpy(instance, matrix.getValue(), 16 * sizeof(float));
+
+    if(material->instanceNormalMatrixId != -1)
+    {
+      Matrix4x4 normalMat = (material->getMatrix(viewId) * matrix.inverse()).transpose();
+      memcpy(instance + 16, normalMat.getValue(), 16 * sizeof(float));
+    }
+
+    drawMeshInstances(mesh, materialIndex, instance, 1);
+
+    return;
   }
 
+  shader->setUniform(material->modelUniformId, GL_FLOAT_MAT4, matrix.getValue(), NULL);
+
   //GLint positionAttribId = glGetAttribLocation(shader->programId, "in_Position");
   GLint positionAttribId = material->positionId;
   //GLint normalAttribId = glGetAttribLocation(shader->programId, "in_Normal");
@@ -325,44 +711,32 @@ void Graphics::drawMeshNow(ref<Mesh> mesh, Matrix4x4 matrix, int materialIndex)
   GLint normalAttribId = material->normalId;
   GLint uvAttribId = material->uvId;
 
-  if(positionAttribId != -1)
-  {
-    glBindBuffer(GL_ARRAY_BUFFER, mesh->positionBufferIds.at(materialIndex)->getGLuint());
-    glVertexAttribPointer(positionAttribId, 3, GL_FLOAT, GL_FALSE, 0, 0);
-    glEnableVertexAttribArray(positionAttribId);
-  }
+  mesh->prepare();
 
-  if(normalAttribId != -1 && mesh->normalBufferIds.size() > materialIndex)
-  {
-    glBindBuffer(GL_ARRAY_BUFFER, mesh->normalBufferIds.at(materialIndex)->getGLuint());
-    glVertexAttribPointer(normalAttribId, 3, GL_FLOAT, GL_FALSE, 0, 0);
-    glEnableVertexAttribArray(normalAttribId);
-  }
+  int indexSize = sizeof(GLushort);
 
-  if(uvAttribId != -1)
+  if(mesh->indexType == GL_UNSIGNED_INT)
   {
-    glBindBuffer(GL_ARRAY_BUFFER, mesh->uvBufferIds.at(materialIndex)->getGLuint());
-    glVertexAttribPointer(uvAttribId, 2, GL_FLOAT, GL_FALSE, 0, 0);
-    glEnableVertexAttribArray(uvAttribId);
+    indexSize = sizeof(GLuint);
   }
 
-  std::vector<int>& triangles = mesh->getTriangles(materialIndex);
-  glDrawArrays(GL_TRIANGLES, 0, triangles.size());
+  GLsizei count = mesh->submeshCounts.at(materialIndex);
+  GLvoid* offset = (GLvoid*)(size_t)(mesh->submeshOffsets.at(materialIndex) * indexSize);
+  GLuint vertexArrayId = mesh->getVertexArray(positionAttribId, normalAttribId, uvAttribId);
 
-  if(positionAttribId != -1)
+  if(vertexArrayId != 0)
   {
-    glDisableVertexAttribArray(positionAttribId);
-  }
+    glBindVertexArray(vertexArrayId);
+    glDrawElements(GL_TRIANGLES, count, mesh->indexType, offset);
+    glBindVertexArray(0);
 
-  if(normalAttribId != -1 && mesh->normalBufferIds.size() > materialIndex)
-  {
-    glDisableVertexAttribArray(normalAttribId);
+    return;
   }
 
-  if(uvAttribId != -1)
-  {
-    glDisableVertexAttribArray(uvAttribId);
-  }
+  // Without vertex array support the layout is bound and undone every draw
+  mesh->bindAttributes(positionAttribId, normalAttribId, uvAttribId);
+  glDrawElements(GL_TRIANGLES, count, mesh->indexType, offset);
+  mesh->unbindAttributes(positionAttribId, normalAttribId, uvAttribId);
 }
 
 }
@@ -4,11 +4,11 @@
 #include "ref.h"
 #include "Rect.h"
 #include "Color.h"
-
-#include <GL/glew.h>
+#include "internal/OpenGl.h"
 
 #include <string>
 #include <vector>
+#include <map>
 
 namespace mutiny
 {
@@ -27,6 +27,11 @@ class Application;
 class GraphicsCache;
 class Graphics;
 
+namespace internal
+{
+  class RenderQueue;
+}
+
 class GraphicsCacheEntry : public enable_ref
 {
   friend class mutiny::engine::GraphicsCache;
@@ -37,7 +42,12 @@ private:
   std::vector<Rect> rects;
   std::vector<Rect> sourceRects;
   shared<Mesh> mesh;
-  int useCount;
+  unsigned int hash;
+  int lastUsed;
+
+  // Intrusive least recently used list, most recent at the head
+  GraphicsCacheEntry* prev;
+  GraphicsCacheEntry* next;
 
 };
 
@@ -47,12 +57,27 @@ class GraphicsCache : public enable_ref
   friend class mutiny::engine::Application;
 
 private:
+  static const int DEFAULT_CAPACITY = 1024;
+  static const int MAX_UNUSED_FRAMES = 10;
+
   static shared<GraphicsCache> create();
-  shared<Mesh> matchMesh(std::vector<Rect>& rects, std::vector<Rect>& sourceRects);
-  void addMesh(std::vector<Rect>& rects, std::vector<Rect>& sourceRects, shared<Mesh> mesh);
+  static unsigned int hashRects(std::vector<Rect>& rects, std::vector<Rect>& sourceRects);
+
+  shared<Mesh> matchMesh(std::vector<Rect>& rects, std::vector<Rect>& sourceRects, unsigned int hash);
+  void addMesh(std::vector<Rect>& rects, std::vector<Rect>& sourceRects, unsigned int hash, shared<Mesh> mesh);
   void sweepUnused();
 
-  std::vector<shared<GraphicsCacheEntry> > entries;
+  void link(GraphicsCacheEntry* entry);
+  void unlink(GraphicsCacheEntry* entry);
+  void evict(GraphicsCacheEntry* entry);
+
+  std::multimap<unsigned int, shared<GraphicsCacheEntry> > entries;
+  GraphicsCacheEntry* head;
+  GraphicsCacheEntry* tail;
+  int capacity;
+  int frame;
+  int hits;
+  int misses;
 
 };
 
@@ -60,6 +85,7 @@ class Graphics
 {
   friend class mutiny::engine::Gui;
   friend class mutiny::engine::Application;
+  friend class mutiny::engine::internal::RenderQueue;
 
 public:
   static void setRenderTarget(ref<RenderTexture> renderTarget);
@@ -69,8 +95,18 @@ public:
   static void drawTexture(Rect rect, ref<Texture> texture, Rect sourceRect, int leftBorder, int rightBorder, int topBorder, int bottomBorder, ref<Material> material);
 
   static void drawMeshNow(ref<Mesh> mesh, Matrix4x4 matrix, int materialIndex);
+  static void drawMeshInstanced(ref<Mesh> mesh, int submesh, ref<Material> material, std::vector<Matrix4x4>& matrices);
+
+  static void setCacheCapacity(int capacity);
+  static int getCacheCapacity();
+  static int getCacheSize();
+  static int getCacheHits();
+  static int getCacheMisses();
+  static void resetCacheStats();
 
 private:
+  static void drawMeshInstances(ref<Mesh> mesh, int submesh, const float* instances, int count);
+
   static void drawTextureBatch(std::vector<Rect> rects, ref<Texture> texture, std::vector<Rect> sourceRects, ref<Material> material);
 
 };
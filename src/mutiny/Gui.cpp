@@ -16,8 +16,8 @@
 #include "Texture.h"
 #include "Texture2d.h"
 #include "TextAnchor.h"
-
-#include <GL/glew.h>
+#include "internal/TextLayoutCache.h"
+#include "internal/OpenGl.h"
 
 #include <vector>
 #include <string>
@@ -41,65 +41,19 @@ void Gui::setMatrix(Matrix4x4 matrix)
 
 void Gui::label(Rect rect, std::string text)
 {
-  ref<GuiSkin> skin = getSkin();
-
-  std::vector<Rect> positions;
-  std::vector<Rect> uvs;
-
-  for(int i = 0; i < text.length(); i++)
+  if(text.length() < 1)
   {
-    CharacterInfo info = {};
-    int padding = 0;
-
-    if(skin->getButton()->getAlignment() == TextAnchor::MiddleLeft)
-    {
-      padding = 10;
-    }
-
-    if(skin->getButton()->font->getCharacterInfo(text[i], info) == false)
-    {
-      continue;
-    }
-
-    if((info.vert.width * (float)i) + padding > rect.width - padding)
-    {
-      break;
-    }
-
-    if(skin->getButton()->getAlignment() == TextAnchor::MiddleLeft)
-    {
-      positions.push_back(Rect(rect.x + padding + info.vert.width * i,
-                               rect.y + (rect.height / 2) - (info.vert.height / 2),
-                               info.vert.width, info.vert.height));
-
-      uvs.push_back(info.uv);
-
-      //drawTextureWithTexCoords(Rect(rect.x + padding + info.vert.width * i,
-      //                              rect.y + (rect.height / 2) - (info.vert.height / 2),
-      //                              info.vert.width,
-      //                              info.vert.height),
-      //                              (Texture*)skin->getButton()->font->texture.get(), info.uv);
-
-    }
-    else
-    {
-      positions.push_back(Rect(rect.x + (rect.width / 2) - ((info.vert.width * text.length()) / 2) + info.vert.width * i,
-                               rect.y + (rect.height / 2) - (info.vert.height / 2),
-                               info.vert.width, info.vert.height));
+    return;
+  }
 
-      uvs.push_back(info.uv);
+  ref<GuiStyle> style = getSkin()->getButton();
 
-      //drawTextureWithTexCoords(Rect(rect.x + (rect.width / 2) - ((info.vert.width * text.length()) / 2) + info.vert.width * i,
-      //                              rect.y + (rect.height / 2) - (info.vert.height / 2),
-      //                              info.vert.width,
-      //                              info.vert.height),
-      //                              (Texture*)skin->getButton()->font->texture.get(), info.uv);
-    }
-  }
+  internal::TextLayout* layout = Application::context->textLayoutCache->getLayout(
+    style->font, text, rect, style->getAlignment());
 
-  if(positions.size() == uvs.size() && positions.size() > 0)
+  if(layout->positions.size() > 0)
   {
-    drawTextureWithTexCoords(positions, skin->getButton()->font->texture.get(), uvs);
+    drawTextureWithTexCoords(layout->positions, style->font->texture.get(), layout->uvs);
   }
 }
 
@@ -160,13 +114,10 @@ bool Gui::button(Rect rect, std::string text)
   return false;
 }
 
-void Gui::drawTextureWithTexCoords(std::vector<Rect> positions, ref<Texture> texture, std::vector<Rect> texCoords)
+void Gui::drawTextureWithTexCoords(std::vector<Rect>& positions, ref<Texture> texture, std::vector<Rect>& texCoords)
 {
   ref<Material> guiMaterial = Application::context->guiMaterial;
 
-  guiMaterial->setMatrix("in_Projection", Matrix4x4::ortho(0, Screen::getWidth(), Screen::getHeight(), 0, -1, 1));
-  guiMaterial->setMatrix("in_View", Matrix4x4::getIdentity());
-  guiMaterial->setMatrix("in_Model", getMatrix());
   Graphics::drawTextureBatch(positions, texture.get(), texCoords, guiMaterial.get());
 }
 
@@ -174,9 +125,6 @@ void Gui::drawTexture(Rect rect, ref<Texture> texture)
 {
   ref<Material> guiMaterial = Application::context->guiMaterial;
 
-  guiMaterial->setMatrix("in_Projection", Matrix4x4::ortho(0, Screen::getWidth(), Screen::getHeight(), 0, -1, 1));
-  guiMaterial->setMatrix("in_View", Matrix4x4::getIdentity());
-  guiMaterial->setMatrix("in_Model", getMatrix());
   Graphics::drawTexture(rect, texture.get(), guiMaterial.get());
 }
 
@@ -184,9 +132,6 @@ void Gui::drawTextureWithTexCoords(Rect position, ref<Texture> texture, Rect tex
 {
   ref<Material> guiMaterial = Application::context->guiMaterial;
 
-  guiMaterial->setMatrix("in_Projection", Matrix4x4::ortho(0, Screen::getWidth(), Screen::getHeight(), 0, -1, 1));
-  guiMaterial->setMatrix("in_View", Matrix4x4::getIdentity());
-  guiMaterial->setMatrix("in_Model", getMatrix());
   Graphics::drawTexture(position, texture.get(), texCoords, guiMaterial.get());
 }
 
@@ -194,10 +139,6 @@ void Gui::drawUi(Rect rect, ref<Texture> texture, ref<GuiStyle> style)
 {
   ref<Material> guiMaterial = Application::context->guiMaterial;
 
-  guiMaterial->setMatrix("in_Projection", Matrix4x4::ortho(0, Screen::getWidth(), Screen::getHeight(), 0, -1, 1));
-  guiMaterial->setMatrix("in_View", Matrix4x4::getIdentity());
-  guiMaterial->setMatrix("in_Model", getMatrix());
-
   Graphics::drawTexture(rect, texture.get(), Rect(0, 0, 1, 1),
                         style->border.left,
                         style->border.right,
@@ -4,8 +4,7 @@
 #include "Rect.h"
 #include "Matrix4x4.h"
 #include "ref.h"
-
-#include <GL/glew.h>
+#include "internal/OpenGl.h"
 
 #include <string>
 #include <vector>
@@ -40,8 +39,8 @@ public:
 private:
   static void drawUi(Rect rect, ref<Texture> texture, ref<GuiStyle> style);
 
-  static void drawTextureWithTexCoords(std::vector<Rect> positions,
-    ref<Texture> texture, std::vector<Rect> texCoords);
+  static void drawTextureWithTexCoords(std::vector<Rect>& positions,
+    ref<Texture> texture, std::vector<Rect>& texCoords);
 
 };
 
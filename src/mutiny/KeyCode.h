@@ -50,6 +50,21 @@ public:
   static const int MOUSE2 = GLUT_RIGHT_BUTTON;
 #endif
 
+#ifdef USE_HEADLESS
+  static const int UP = 101;
+  static const int DOWN = 103;
+  static const int RIGHT = 102;
+  static const int LEFT = 100;
+  static const int SPACE = ' ';
+  static const int A = 'a';
+  static const int D = 'd';
+  static const int W = 'w';
+  static const int S = 's';
+  static const int MOUSE0 = 0;
+  static const int MOUSE1 = 1;
+  static const int MOUSE2 = 2;
+#endif
+
 };
 
 }
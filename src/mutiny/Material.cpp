@@ -8,6 +8,7 @@
 #include "Debug.h"
 #include "Exception.h"
 
+#include <cstring>
 #include <memory>
 #include <functional>
 
@@ -66,11 +67,13 @@ Material::Material(std::string vertContents, std::string fragContents)
 {
   managedShader = Shader::create(vertContents, fragContents);
   indexesDirty = true;
+  renderQueue = GEOMETRY_QUEUE;
   refreshIds();
 }
 
 Material::Material()
 {
+  renderQueue = GEOMETRY_QUEUE;
 }
 
 shared<Material> Material::create(std::string vertContents, std::string fragContents)
@@ -97,6 +100,7 @@ Material::Material(ref<Material> material)
 {
   shader = material->getShader();
   indexesDirty = true;
+  renderQueue = material->renderQueue;
   refreshIds();
 }
 
@@ -104,14 +108,20 @@ Material::Material(ref<Shader> shader)
 {
   this->shader = shader;
   indexesDirty = true;
+  renderQueue = GEOMETRY_QUEUE;
   refreshIds();
 }
 
 ref<Texture> Material::getTexture(std::string propertyName)
 {
-  for(size_t i = 0; i < textureNames.size(); i++)
+  return getTexture(Shader::propertyToId(propertyName));
+}
+
+ref<Texture> Material::getTexture(int propertyId)
+{
+  for(size_t i = 0; i < textureIds.size(); i++)
   {
-    if(textureNames.at(i) == propertyName)
+    if(textureIds[i] == propertyId)
     {
       return textures.at(i).get();
     }
@@ -123,82 +133,121 @@ ref<Texture> Material::getTexture(std::string propertyName)
 void Material::setTexture(std::string propertyName, ref<Texture2d> texture)
 {
   ref<Texture> tex = texture.get();
-  setTexture(propertyName, tex);
+  setTexture(Shader::propertyToId(propertyName), tex);
 }
 
 void Material::setTexture(std::string propertyName, ref<Texture> texture)
 {
-  for(size_t i = 0; i < textureNames.size(); i++)
+  setTexture(Shader::propertyToId(propertyName), texture);
+}
+
+void Material::setTexture(int propertyId, ref<Texture2d> texture)
+{
+  ref<Texture> tex = texture.get();
+  setTexture(propertyId, tex);
+}
+
+void Material::setTexture(int propertyId, ref<Texture> texture)
+{
+  for(size_t i = 0; i < textureIds.size(); i++)
   {
-    if(textureNames.at(i) == propertyName)
+    if(textureIds[i] == propertyId)
     {
       textures.at(i) = texture;
+      textureDirty[i] = true;
       return;
     }
   }
 
   textures.push_back(texture);
   textureIndexes.push_back(-1);
-  textureNames.push_back(propertyName);
+  textureIds.push_back(propertyId);
+  textureDirty.push_back(true);
   indexesDirty = true;
 }
 
 void Material::setVector(std::string propertyName, Vector2 value)
 {
-  for(size_t i = 0; i < vector2Names.size(); i++)
+  setVector(Shader::propertyToId(propertyName), value);
+}
+
+void Material::setVector(int propertyId, Vector2 value)
+{
+  for(size_t i = 0; i < vector2Ids.size(); i++)
   {
-    if(vector2Names.at(i) == propertyName)
+    if(vector2Ids[i] == propertyId)
     {
       vector2s[i] = value;
+      vector2Dirty[i] = true;
       return;
     }
   }
 
   vector2s.push_back(value);
   vector2Indexes.push_back(-1);
-  vector2Names.push_back(propertyName);
+  vector2Ids.push_back(propertyId);
+  vector2Dirty.push_back(true);
   indexesDirty = true;
 }
 
 void Material::setFloat(std::string propertyName, float value)
 {
-  for(size_t i = 0; i < floatNames.size(); i++)
+  setFloat(Shader::propertyToId(propertyName), value);
+}
+
+void Material::setFloat(int propertyId, float value)
+{
+  for(size_t i = 0; i < floatIds.size(); i++)
   {
-    if(floatNames.at(i) == propertyName)
+    if(floatIds[i] == propertyId)
     {
       floats[i] = value;
+      floatDirty[i] = true;
       return;
     }
   }
 
   floats.push_back(value);
   floatIndexes.push_back(-1);
-  floatNames.push_back(propertyName);
+  floatIds.push_back(propertyId);
+  floatDirty.push_back(true);
   indexesDirty = true;
 }
 
 void Material::setMatrix(std::string propertyName, Matrix4x4 matrix)
 {
-  for(size_t i = 0; i < matrixNames.size(); i++)
+  setMatrix(Shader::propertyToId(propertyName), matrix);
+}
+
+void Material::setMatrix(int propertyId, Matrix4x4 matrix)
+{
+  for(size_t i = 0; i < matrixIds.size(); i++)
   {
-    if(matrixNames.at(i) == propertyName)
+    if(matrixIds[i] == propertyId)
     {
       matrices[i] = matrix;
+      matrixDirty[i] = true;
       return;
     }
   }
 
   matrices.push_back(matrix);
   matrixIndexes.push_back(-1);
-  matrixNames.push_back(propertyName);
+  matrixIds.push_back(propertyId);
+  matrixDirty.push_back(true);
   indexesDirty = true;
 }
 
 Matrix4x4 Material::getMatrix(std::string propertyName)
 {
-  for(size_t i = 0; i < matrixNames.size(); i++)
+  return getMatrix(Shader::propertyToId(propertyName));
+}
+
+Matrix4x4 Material::getMatrix(int propertyId)
+{
+  for(size_t i = 0; i < matrixIds.size(); i++)
   {
-    if(matrixNames.at(i) == propertyName)
+    if(matrixIds[i] == propertyId)
     {
       return matrices[i];
     }
@@ -210,22 +259,26 @@ Matrix4x4 Material::getMatrix(std::string propertyName)
 
 void Material::refreshIndexes()
 {
-  for(size_t i = 0; i < matrixNames.size(); i++)
+  GLuint programId = getShader()->programId->getGLuint();
+
+  for(size_t i = 0; i < matrixIds.size(); i++)
   {
-    GLuint uniformId = glGetUniformLocation(getShader()->programId->getGLuint(), matrixNames.at(i).c_str());
+    matrixDirty[i] = true;
+    GLuint uniformId = glGetUniformLocation(programId, Shader::idToProperty(matrixIds[i]).c_str());
 
     if(uniformId == -1)
     {
-      //Debug::logWarning("The specified matrix name '" + matrixNames.at(i) + "' was not found in the shader");
+      //Debug::logWarning("The specified matrix name was not found in the shader");
       continue;
     }
 
     matrixIndexes[i] = uniformId;
   }
 
-  for(size_t i = 0; i < vector2Names.size(); i++)
+  for(size_t i = 0; i < vector2Ids.size(); i++)
   {
-    GLuint uniformId = glGetUniformLocation(getShader()->programId->getGLuint(), vector2Names.at(i).c_str());
+    vector2Dirty[i] = true;
+    GLuint uniformId = glGetUniformLocation(programId, Shader::idToProperty(vector2Ids[i]).c_str());
 
     if(uniformId == -1)
     {
@@ -236,9 +289,10 @@ void Material::refreshIndexes()
     vector2Indexes[i] = uniformId;
   }
 
-  for(size_t i = 0; i < floatNames.size(); i++)
+  for(size_t i = 0; i < floatIds.size(); i++)
   {
-    GLuint uniformId = glGetUniformLocation(getShader()->programId->getGLuint(), floatNames.at(i).c_str());
+    floatDirty[i] = true;
+    GLuint uniformId = glGetUniformLocation(programId, Shader::idToProperty(floatIds[i]).c_str());
 
     if(uniformId == -1)
     {
@@ -249,9 +303,10 @@ void Material::refreshIndexes()
     floatIndexes[i] = uniformId;
   }
 
-  for(size_t i = 0; i < textureNames.size(); i++)
+  for(size_t i = 0; i < textureIds.size(); i++)
   {
-    GLint uniformId = glGetUniformLocation(getShader()->programId->getGLuint(), textureNames.at(i).c_str());
+    textureDirty[i] = true;
+    GLint uniformId = glGetUniformLocation(programId, Shader::idToProperty(textureIds[i]).c_str());
 
     if(uniformId == -1)
     {
@@ -262,22 +317,117 @@ void Material::refreshIndexes()
     textureIndexes[i] = uniformId;
   }
 
+  indexesDirty = false;
   refreshIds();
 }
 
+// Matrices set for each pass by the render queue and Graphics, which do
+// not say anything about the material itself
+static bool isPassMatrix(int id)
+{
+  static int projectionId = Shader::propertyToId("in_Projection");
+  static int viewId = Shader::propertyToId("in_View");
+  static int modelId = Shader::propertyToId("in_Model");
+  static int normalMatrixId = Shader::propertyToId("in_NormalMatrix");
+
+  return id == projectionId || id == viewId || id == modelId || id == normalMatrixId;
+}
+
+// Whether drawing with the other material gives the same result, so that
+// draws using either can share one instanced draw
+bool Material::matches(Material* other)
+{
+  if(other == this)
+  {
+    return true;
+  }
+
+  if(shader.try_get() != other->shader.try_get() || renderQueue != other->renderQueue)
+  {
+    return false;
+  }
+
+  if(floatIds != other->floatIds || vector2Ids != other->vector2Ids ||
+    textureIds != other->textureIds || floats != other->floats)
+  {
+    return false;
+  }
+
+  for(size_t i = 0; i < vector2s.size(); i++)
+  {
+    if(vector2s.at(i).x != other->vector2s.at(i).x ||
+      vector2s.at(i).y != other->vector2s.at(i).y)
+    {
+      return false;
+    }
+  }
+
+  for(size_t i = 0; i < textures.size(); i++)
+  {
+    if(textures.at(i).try_get() != other->textures.at(i).try_get())
+    {
+      return false;
+    }
+  }
+
+  // Only one material of a run has its pass matrices set so those may be
+  // present on one and not the other
+  size_t count = 0;
+  size_t otherCount = 0;
+
+  for(size_t i = 0; i < other->matrixIds.size(); i++)
+  {
+    if(isPassMatrix(other->matrixIds.at(i)) == false)
+    {
+      otherCount++;
+    }
+  }
+
+  for(size_t i = 0; i < matrixIds.size(); i++)
+  {
+    if(isPassMatrix(matrixIds.at(i)) == true)
+    {
+      continue;
+    }
+
+    size_t j = 0;
+
+    while(j < other->matrixIds.size() && other->matrixIds.at(j) != matrixIds.at(i))
+    {
+      j++;
+    }
+
+    if(j == other->matrixIds.size() || memcmp(matrices.at(i).getValue(),
+      other->matrices.at(j).getValue(), 16 * sizeof(float)) != 0)
+    {
+      return false;
+    }
+
+    count++;
+  }
+
+  return count == otherCount;
+}
+
 ref<Texture> Material::getMainTexture()
 {
-  return getTexture("in_Texture");
+  static int mainTextureId = Shader::propertyToId("in_Texture");
+
+  return getTexture(mainTextureId);
 }
 
 void Material::setMainTexture(ref<Texture> texture)
 {
-  setTexture("in_Texture", texture);
+  static int mainTextureId = Shader::propertyToId("in_Texture");
+
+  setTexture(mainTextureId, texture);
 }
 
 void Material::setMainTexture(ref<Texture2d> texture)
 {
-  setTexture("in_Texture", texture);
+  static int mainTextureId = Shader::propertyToId("in_Texture");
+
+  setTexture(mainTextureId, texture);
 }
 
 ref<Shader> Material::getShader()
@@ -305,6 +455,19 @@ void Material::refreshIds()
   uvId = glGetAttribLocation(getShader()->programId->getGLuint(), "in_Uv");
   normalId = glGetAttribLocation(getShader()->programId->getGLuint(), "in_Normal");
   modelUniformId = glGetUniformLocation(getShader()->programId->getGLuint(), "in_Model");
+  normalMatrixUniformId = glGetUniformLocation(getShader()->programId->getGLuint(), "in_NormalMatrix");
+  instanceModelId = glGetAttribLocation(getShader()->programId->getGLuint(), "in_InstanceModel");
+  instanceNormalMatrixId = glGetAttribLocation(getShader()->programId->getGLuint(), "in_InstanceNormalMatrix");
+}
+
+void Material::setRenderQueue(int renderQueue)
+{
+  this->renderQueue = renderQueue;
+}
+
+int Material::getRenderQueue()
+{
+  return renderQueue;
 }
 
 int Material::getPassCount()
@@ -315,31 +478,69 @@ int Material::getPassCount()
 void Material::setPass(int pass, ref<Material> _this)
 {
   Application::context->currentMaterial = _this;
-  glUseProgram(getShader()->programId->getGLuint());
+
+  // Materials sharing a shader are drawn back to back by the render queue
+  // so the program often does not need to change.
+  if(Application::context->currentShader.try_get() != getShader().try_get())
+  {
+    Application::context->currentShader = getShader();
+    glUseProgram(getShader()->programId->getGLuint());
+  }
 
   if(indexesDirty == true)
   {
     refreshIndexes();
   }
 
-  for(size_t i = 0; i < matrixNames.size(); i++)
+  Shader* shader = getShader().get();
+
+  // A property is skipped when it has not changed since this material last
+  // uploaded it and no other material has written that uniform since.
+  for(size_t i = 0; i < matrices.size(); i++)
   {
-    glUniformMatrix4fv(matrixIndexes[i], 1, GL_FALSE, matrices[i].getValue());
+    if(matrixDirty[i] == false && shader->isResident(matrixIndexes[i], this) == true)
+    {
+      continue;
+    }
+
+    shader->setUniform(matrixIndexes[i], GL_FLOAT_MAT4, matrices[i].getValue(), this);
+    matrixDirty[i] = false;
   }
 
-  for(size_t i = 0; i < vector2Names.size(); i++)
+  for(size_t i = 0; i < vector2s.size(); i++)
   {
-    glUniform2f(vector2Indexes[i], vector2s[i].x, vector2s[i].y);
+    if(vector2Dirty[i] == false && shader->isResident(vector2Indexes[i], this) == true)
+    {
+      continue;
+    }
+
+    float values[2] = { vector2s[i].x, vector2s[i].y };
+    shader->setUniform(vector2Indexes[i], GL_FLOAT_VEC2, values, this);
+    vector2Dirty[i] = false;
   }
 
-  for(size_t i = 0; i < floatNames.size(); i++)
+  for(size_t i = 0; i < floats.size(); i++)
   {
-    glUniform1f(floatIndexes[i], floats[i]);
+    if(floatDirty[i] == false && shader->isResident(floatIndexes[i], this) == true)
+    {
+      continue;
+    }
+
+    shader->setUniform(floatIndexes[i], GL_FLOAT, &floats[i], this);
+    floatDirty[i] = false;
   }
 
-  for(size_t i = 0; i < textureNames.size(); i++)
+  // Texture units are shared by every program and are also bound outside of
+  // materials so only the sampler uniform can be cached.
+  for(size_t i = 0; i < textures.size(); i++)
   {
-    glUniform1i(textureIndexes[i], i);
+    if(textureDirty[i] == true || shader->isResident(textureIndexes[i], this) == false)
+    {
+      float unit = i;
+      shader->setUniform(textureIndexes[i], GL_SAMPLER_2D, &unit, this);
+      textureDirty[i] = false;
+    }
+
     glActiveTexture(GL_TEXTURE0 + i);
     glBindTexture(GL_TEXTURE_2D, textures.at(i)->getNativeTexture());
   }
@@ -4,8 +4,7 @@
 #include "Object.h"
 #include "Matrix4x4.h"
 #include "Vector2.h"
-
-#include <GL/glew.h>
+#include "internal/OpenGl.h"
 
 #include <memory>
 #include <vector>
@@ -27,6 +26,12 @@ class Texture2d;
 class ParticleRenderer;
 class Graphics;
 
+namespace internal
+{
+  class RenderQueue;
+  class GuiDrawList;
+}
+
 class Material : public Object
 {
   friend class mutiny::engine::Resources;
@@ -35,8 +40,13 @@ class Material : public Object
   friend class mutiny::engine::Gui;
   friend class mutiny::engine::ParticleRenderer;
   friend class mutiny::engine::Graphics;
+  friend class mutiny::engine::internal::RenderQueue;
+  friend class mutiny::engine::internal::GuiDrawList;
 
 public:
+  static const int GEOMETRY_QUEUE = 2000;
+  static const int TRANSPARENT_QUEUE = 3000;
+
   Material();
   Material(std::string vertContents, std::string fragContents);
   Material(ref<Shader> shader);
@@ -48,31 +58,45 @@ public:
   ref<Shader> getShader();
   void setShader(ref<Shader> shader);
   void setMatrix(std::string propertyName, Matrix4x4 matrix);
+  void setMatrix(int propertyId, Matrix4x4 matrix);
   Matrix4x4 getMatrix(std::string propertyName);
+  Matrix4x4 getMatrix(int propertyId);
   void setFloat(std::string propertyName, float value);
+  void setFloat(int propertyId, float value);
   void setVector(std::string propertyName, Vector2 value);
+  void setVector(int propertyId, Vector2 value);
   void setTexture(std::string propertyName, ref<Texture> texture);
   void setTexture(std::string propertyName, ref<Texture2d> texture);
+  void setTexture(int propertyId, ref<Texture> texture);
+  void setTexture(int propertyId, ref<Texture2d> texture);
   ref<Texture> getTexture(std::string propertyName);
+  ref<Texture> getTexture(int propertyId);
   void setMainTexture(ref<Texture> texture);
   void setMainTexture(ref<Texture2d> texture);
   ref<Texture> getMainTexture();
 
+  void setRenderQueue(int renderQueue);
+  int getRenderQueue();
+
   int getPassCount();
   void setPass(int pass, ref<Material> _this);
 
 private:
   static ref<Material> load(std::string path);
 
-  std::vector<Matrix4x4> matrices; std::vector<GLuint> matrixIndexes; std::vector<std::string> matrixNames;
-  std::vector<float> floats; std::vector<GLuint> floatIndexes; std::vector<std::string> floatNames;
-  std::vector<Vector2> vector2s; std::vector<GLuint> vector2Indexes; std::vector<std::string> vector2Names;
-  std::vector<ref<Texture> > textures; std::vector<GLuint> textureIndexes; std::vector<std::string> textureNames;
+  std::vector<Matrix4x4> matrices; std::vector<GLuint> matrixIndexes; std::vector<int> matrixIds; std::vector<char> matrixDirty;
+  std::vector<float> floats; std::vector<GLuint> floatIndexes; std::vector<int> floatIds; std::vector<char> floatDirty;
+  std::vector<Vector2> vector2s; std::vector<GLuint> vector2Indexes; std::vector<int> vector2Ids; std::vector<char> vector2Dirty;
+  std::vector<ref<Texture> > textures; std::vector<GLuint> textureIndexes; std::vector<int> textureIds; std::vector<char> textureDirty;
 
   GLint positionId;
   GLint uvId;
   GLint normalId;
   GLint modelUniformId;
+  GLint normalMatrixUniformId;
+  GLint instanceModelId;
+  GLint instanceNormalMatrixId;
+  int renderQueue;
 
   shared<Shader> managedShader;
   ref<Shader> shader;
@@ -80,6 +104,7 @@ private:
   bool indexesDirty;
   void refreshIndexes();
   void refreshIds();
+  bool matches(Material* other);
 
 };
 
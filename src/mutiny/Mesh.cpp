@@ -3,8 +3,9 @@
 #include "Color.h"
 #include "Debug.h"
 #include "Exception.h"
+#include "Resources.h"
 
-#include "internal/WavefrontParser.h"
+#include "internal/MeshFile.h"
 
 #include <iostream>
 #include <memory>
@@ -18,99 +19,256 @@ namespace engine
 
 ref<Mesh> Mesh::load(std::string path)
 {
-  internal::WavefrontParser parser(path + ".obj");
-  ref<internal::ModelData> modelData = parser.getModelData();
-  std::vector<Vector3> vertices;
-  std::vector<Vector3> normals;
-  std::vector<Vector2> uv;
-  std::vector<Color> colors;
-  std::vector<std::vector<int> > triangles;
-  int currentSubmesh = 0;
+  shared<internal::MeshFile> file = internal::MeshFile::load(path);
+  ref<Mesh> mesh = new Mesh();
+
+  mesh->path = path;
+  mesh->setFile(file);
+
+  Debug::log("Loading mesh");
+
+  return mesh;
+}
+
+// Submeshes are created empty so their count is known before the file is
+// copied out
+void Mesh::setFile(shared<internal::MeshFile> file)
+{
+  internal::MeshFileHeader* header = file->header;
+
+  this->file = file;
+  triangles.clear();
+  triangles.resize(header->submeshCount);
+
+  bounds.setMinMax(
+    Vector3(header->boundsMin[0], header->boundsMin[1], header->boundsMin[2]),
+    Vector3(header->boundsMax[0], header->boundsMax[1], header->boundsMax[2]));
+
+  dirty = true;
+}
+
+void Mesh::fill(internal::MeshFile* file)
+{
+  internal::MeshFileHeader* header = file->header;
+
+  vertices.resize(header->vertexCount);
+  normals.resize(header->vertexCount);
+  uv.resize(header->vertexCount);
+  colors.resize(header->vertexCount);
 
-  for(size_t p = 0; p < modelData->parts.size(); p++)
+  for(size_t i = 0; i < header->vertexCount; i++)
   {
-    ref<internal::PartData> part = modelData->parts.at(p);
+    internal::MeshFileVertex& vertex = file->vertices[i];
 
-    for(size_t m = 0; m < part->materialGroups.size(); m++)
-    {
-      ref<internal::MaterialGroupData> materialGroup = part->materialGroups.at(m);
-      triangles.push_back(std::vector<int>());
+    vertices[i] = Vector3(vertex.position[0], vertex.position[1], vertex.position[2]);
+    normals[i] = Vector3(vertex.normal[0], vertex.normal[1], vertex.normal[2]);
+    uv[i] = Vector2(vertex.uv[0], vertex.uv[1]);
+    colors[i] = Color(vertex.color[0], vertex.color[1], vertex.color[2], vertex.color[3]);
+  }
 
-      for(size_t f = 0; f < materialGroup->faces.size(); f++)
-      {
-        ref<internal::FaceData> face = materialGroup->faces.at(f);
-
-        triangles.at(currentSubmesh).push_back(vertices.size());
-        vertices.push_back(Vector3(face->a.position.x, face->a.position.y, face->a.position.z));
-        triangles.at(currentSubmesh).push_back(vertices.size());
-        vertices.push_back(Vector3(face->b.position.x, face->b.position.y, face->b.position.z));
-        triangles.at(currentSubmesh).push_back(vertices.size());
-        vertices.push_back(Vector3(face->c.position.x, face->c.position.y, face->c.position.z));
-
-        normals.push_back(Vector3(face->a.normal.x, face->a.normal.y, face->a.normal.z));
-        normals.push_back(Vector3(face->b.normal.x, face->b.normal.y, face->b.normal.z));
-        normals.push_back(Vector3(face->c.normal.x, face->c.normal.y, face->c.normal.z));
-
-        uv.push_back(Vector2(face->a.coord.x, face->a.coord.y));
-        uv.push_back(Vector2(face->b.coord.x, face->b.coord.y));
-        uv.push_back(Vector2(face->c.coord.x, face->c.coord.y));
-
-        colors.push_back(Color(materialGroup->material->color.x,
-                               materialGroup->material->color.y,
-                               materialGroup->material->color.z));
-
-        colors.push_back(Color(materialGroup->material->color.x,
-                               materialGroup->material->color.y,
-                               materialGroup->material->color.z));
-
-        colors.push_back(Color(materialGroup->material->color.x,
-                               materialGroup->material->color.y,
-                               materialGroup->material->color.z));
-      }
+  triangles.clear();
 
-      currentSubmesh++;
-    }
+  for(size_t s = 0; s < header->submeshCount; s++)
+  {
+    unsigned int* first = file->indices + file->submeshes[s].firstIndex;
+
+    triangles.push_back(std::vector<int>(first, first + file->submeshes[s].indexCount));
   }
+}
 
+// Maps an evicted mesh back in from its file
+void Mesh::reload()
+{
+  evicted = false;
 
-  ref<Mesh> mesh = new Mesh();
-  mesh->setVertices(vertices);
-  mesh->setNormals(normals);
-  mesh->setUv(uv);
-  mesh->setColors(colors);
+  try
+  {
+    setFile(internal::MeshFile::load(path));
+  }
+  catch(std::exception& e)
+  {
+    // Left with its submeshes empty so it draws nothing
+    Debug::logError("Failed to reload mesh '" + path + "'");
+    path = "";
+  }
+}
 
-  for(size_t i = 0; i < triangles.size(); i++)
+// Copies the data of a loaded mesh out of its file before it is touched.
+// Buffers already uploaded from the file hold the same data so are kept.
+void Mesh::use()
+{
+  markUsed();
+
+  if(evicted == true)
   {
-    mesh->setTriangles(triangles.at(i), i);
+    reload();
   }
 
-  Debug::log("Loading mesh");
+  if(file.get() != NULL)
+  {
+    fill(file.get());
+    file.reset();
+  }
+}
 
-  return mesh;
+// Everything a draw needs resident and uploaded
+void Mesh::prepare()
+{
+  markUsed();
+
+  if(evicted == true)
+  {
+    reload();
+  }
+
+  if(dirty == true)
+  {
+    upload();
+  }
+}
+
+size_t Mesh::getResidentSize()
+{
+  size_t indexCount = 0;
+
+  for(size_t s = 0; s < triangles.size(); s++)
+  {
+    indexCount += triangles.at(s).size();
+  }
+
+  size_t rtn = vertices.size() * sizeof(Vector3) +
+    normals.size() * sizeof(Vector3) +
+    uv.size() * sizeof(Vector2) +
+    colors.size() * sizeof(Color) +
+    indexCount * sizeof(int);
+
+  if(file.get() != NULL)
+  {
+    rtn += file->header->vertexCount * sizeof(internal::MeshFileVertex) +
+      file->header->indexCount * sizeof(unsigned int);
+  }
+
+  if(vertexBufferId.get() != NULL)
+  {
+    rtn += bufferSize;
+  }
+
+  return rtn;
+}
+
+bool Mesh::canEvict()
+{
+  return path != "" && evicted == false;
+}
+
+// The submeshes are kept, empty, so their count does not change
+void Mesh::evict()
+{
+  std::vector<Vector3>().swap(vertices);
+  std::vector<Vector3>().swap(normals);
+  std::vector<Vector2>().swap(uv);
+  std::vector<Color>().swap(colors);
+
+  for(size_t s = 0; s < triangles.size(); s++)
+  {
+    std::vector<int>().swap(triangles.at(s));
+  }
+
+  file.reset();
+  vertexArrays.clear();
+  vertexBufferId.reset();
+  indexBufferId.reset();
+  bufferSize = 0;
+  dirty = true;
+  evicted = true;
+}
+
+// The whole mesh is built on the loader thread. Only its buffers are left
+// to the main thread.
+template<> void ResourceRequest<Mesh>::decode()
+{
+  for(size_t i = 0; i < paths.size(); i++)
+  {
+    try
+    {
+      object = shared<Mesh>(Mesh::load(paths.at(i)).get());
+
+      return;
+    }
+    catch(std::exception& e) { }
+  }
+}
+
+template<> void ResourceRequest<Mesh>::upload()
+{
+  asset = Resources::find<Mesh>(path);
+
+  if(asset.expired() == true && object.get() != NULL)
+  {
+    Resources::add(path, object);
+    object->upload();
+    asset = object;
+  }
+
+  object.reset();
+  done = true;
+}
+
+Mesh::Mesh()
+{
+  indexType = GL_UNSIGNED_SHORT;
+  vertexStride = 8 * sizeof(GLfloat);
+  bufferSize = 0;
+  usage = GL_STATIC_DRAW;
+  dirty = true;
+  evicted = false;
+}
+
+void Mesh::markDynamic()
+{
+  usage = GL_DYNAMIC_DRAW;
 }
 
 void Mesh::setVertices(std::vector<Vector3> vertices)
 {
+  use();
+  path = "";
   this->vertices = vertices;
+  recalculateBounds();
+  dirty = true;
 }
 
 void Mesh::setColors(std::vector<Color> colors)
 {
+  use();
+  path = "";
   this->colors = colors;
 }
 
 void Mesh::setTriangles(std::vector<int> triangles, int submesh)
 {
-  bool insert = false;
+  use();
+  path = "";
+
+  int submeshCount = (int)this->triangles.size();
+  int vertexCount = (int)vertices.size();
 
-  if(submesh > positionBufferIds.size())
+  if(submesh < 0 || submesh > submeshCount)
   {
     throw Exception("Submesh index out of bounds");
   }
-  else if(submesh == positionBufferIds.size())
+
+  for(size_t i = 0; i < triangles.size(); i++)
+  {
+    if(triangles.at(i) < 0 || triangles.at(i) >= vertexCount)
+    {
+      throw Exception("Triangle index out of bounds");
+    }
+  }
+
+  if(submesh == submeshCount)
   {
     this->triangles.push_back(triangles);
-    insert = true;
   }
   else
   {
@@ -118,135 +276,385 @@ void Mesh::setTriangles(std::vector<int> triangles, int submesh)
   }
 
   recalculateBounds();
+  dirty = true;
+}
+
+void Mesh::upload()
+{
+  if(file.get() != NULL)
+  {
+    uploadFile();
+
+    return;
+  }
 
+  // Interleaved position, normal and uv. Attributes a mesh does not have
+  // are left as zero so that every mesh shares the one layout.
   std::vector<float> values;
+  values.reserve(vertices.size() * 8);
 
-  for(size_t i = 0; i < triangles.size(); i++)
+  for(size_t i = 0; i < vertices.size(); i++)
   {
-    values.push_back(vertices.at(triangles.at(i)).x);
-    values.push_back(vertices.at(triangles.at(i)).y);
-    values.push_back(vertices.at(triangles.at(i)).z);
-  }
+    values.push_back(vertices.at(i).x);
+    values.push_back(vertices.at(i).y);
+    values.push_back(vertices.at(i).z);
 
-  shared<gl::Uint> positionBufferId;
+    if(i < normals.size())
+    {
+      values.push_back(normals.at(i).x);
+      values.push_back(normals.at(i).y);
+      values.push_back(normals.at(i).z);
+    }
+    else
+    {
+      values.push_back(0); values.push_back(0); values.push_back(0);
+    }
+
+    if(i < uv.size())
+    {
+      values.push_back(uv.at(i).x);
+      values.push_back(uv.at(i).y);
+    }
+    else
+    {
+      values.push_back(0); values.push_back(0);
+    }
+  }
 
-  if(insert == true)
+  if(vertexBufferId.get() == NULL)
   {
-    positionBufferId = gl::Uint::genBuffer();
-    positionBufferIds.push_back(positionBufferId);
+    vertexBufferId = gl::Uint::genBuffer();
+    indexBufferId = gl::Uint::genBuffer();
   }
-  else
+
+  setVertexStride(8 * sizeof(GLfloat));
+  glBindBuffer(GL_ARRAY_BUFFER, vertexBufferId->getGLuint());
+
+  if(values.size() > 0)
   {
-    positionBufferId = positionBufferIds.at(submesh);
+    glBufferData(GL_ARRAY_BUFFER, values.size() * sizeof(values[0]), &values[0], usage);
   }
 
-  glBindBuffer(GL_ARRAY_BUFFER, positionBufferId->getGLuint());
-  //glBufferData(GL_ARRAY_BUFFER, values.size() * sizeof(values[0]), &values[0], GL_STATIC_DRAW);
-  glBufferData(GL_ARRAY_BUFFER, values.size() * sizeof(values[0]), &values[0], GL_DYNAMIC_DRAW);
   glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-// Normals
+  // All submeshes share one index buffer, each owning a range of it
+  std::vector<GLushort> shortIndices;
+  std::vector<GLuint> intIndices;
+  submeshOffsets.clear();
+  submeshCounts.clear();
+
+  indexType = GL_UNSIGNED_SHORT;
 
-  if(normals.size() > 0)
+  if(vertices.size() > 65535)
   {
-    values.clear();
+    indexType = GL_UNSIGNED_INT;
+  }
 
-    for(size_t i = 0; i < triangles.size(); i++)
-    {
-      values.push_back(normals.at(triangles.at(i)).x);
-      values.push_back(normals.at(triangles.at(i)).y);
-      values.push_back(normals.at(triangles.at(i)).z);
-    }
+  int offset = 0;
 
-    shared<gl::Uint> normalBufferId;
+  for(size_t s = 0; s < triangles.size(); s++)
+  {
+    submeshOffsets.push_back(offset);
+    submeshCounts.push_back(triangles.at(s).size());
+    offset += triangles.at(s).size();
 
-    if(insert == true)
+    for(size_t i = 0; i < triangles.at(s).size(); i++)
     {
-      normalBufferId = gl::Uint::genBuffer();
-      normalBufferIds.push_back(normalBufferId);
-    }
-    else
-    {
-      normalBufferId = normalBufferIds.at(submesh);
+      if(indexType == GL_UNSIGNED_SHORT)
+      {
+        shortIndices.push_back(triangles.at(s).at(i));
+      }
+      else
+      {
+        intIndices.push_back(triangles.at(s).at(i));
+      }
     }
+  }
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferId->getGLuint());
+
+  if(shortIndices.size() > 0)
+  {
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(shortIndices[0]),
+      &shortIndices[0], usage);
+  }
+  else if(intIndices.size() > 0)
+  {
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, intIndices.size() * sizeof(intIndices[0]),
+      &intIndices[0], usage);
+  }
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  bufferSize = values.size() * sizeof(GLfloat) +
+    shortIndices.size() * sizeof(GLushort) + intIndices.size() * sizeof(GLuint);
+
+  dirty = false;
+}
+
+// The vertex stream of a mesh file already interleaves position, normal and
+// uv at the offsets bindAttributes expects, so it is handed to GL as it is
+// mapped with the trailing colors simply skipped by the stride.
+void Mesh::uploadFile()
+{
+  internal::MeshFileHeader* header = file->header;
+  size_t vertexSize = header->vertexCount * sizeof(internal::MeshFileVertex);
+
+  if(vertexBufferId.get() == NULL)
+  {
+    vertexBufferId = gl::Uint::genBuffer();
+    indexBufferId = gl::Uint::genBuffer();
+  }
 
-    glBindBuffer(GL_ARRAY_BUFFER, normalBufferId->getGLuint());
-    //glBufferData(GL_ARRAY_BUFFER, values.size() * sizeof(values[0]), &values[0], GL_STATIC_DRAW);
-    glBufferData(GL_ARRAY_BUFFER, values.size() * sizeof(values[0]), &values[0], GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  setVertexStride(sizeof(internal::MeshFileVertex));
+  glBindBuffer(GL_ARRAY_BUFFER, vertexBufferId->getGLuint());
+
+  if(vertexSize > 0)
+  {
+    glBufferData(GL_ARRAY_BUFFER, vertexSize, file->vertices, usage);
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  // Submeshes are laid out back to back in the file's index stream
+  submeshOffsets.clear();
+  submeshCounts.clear();
+
+  for(size_t s = 0; s < header->submeshCount; s++)
+  {
+    submeshOffsets.push_back(file->submeshes[s].firstIndex);
+    submeshCounts.push_back(file->submeshes[s].indexCount);
   }
 
-// UVs
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferId->getGLuint());
+  bufferSize = vertexSize;
 
-  if(uv.size() > 0)
+  if(header->vertexCount > 65535)
   {
-    values.clear();
+    indexType = GL_UNSIGNED_INT;
 
-    for(size_t i = 0; i < triangles.size(); i++)
+    if(header->indexCount > 0)
     {
-      values.push_back(uv.at(triangles.at(i)).x);
-      values.push_back(uv.at(triangles.at(i)).y);
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, header->indexCount * sizeof(GLuint),
+        file->indices, usage);
     }
 
-    shared<gl::Uint> uvBufferId;
+    bufferSize += header->indexCount * sizeof(GLuint);
+  }
+  else
+  {
+    std::vector<GLushort> shortIndices(file->indices,
+      file->indices + header->indexCount);
+
+    indexType = GL_UNSIGNED_SHORT;
 
-    if(insert == true)
+    if(shortIndices.size() > 0)
     {
-      uvBufferId = gl::Uint::genBuffer();
-      uvBufferIds.push_back(uvBufferId);
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(shortIndices[0]),
+        &shortIndices[0], usage);
     }
-    else
+
+    bufferSize += shortIndices.size() * sizeof(GLushort);
+  }
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  dirty = false;
+}
+
+// Vertex arrays capture the stride so are rebuilt when the layout changes
+void Mesh::setVertexStride(GLsizei stride)
+{
+  if(stride != vertexStride)
+  {
+    vertexArrays.clear();
+    vertexStride = stride;
+  }
+}
+
+void Mesh::bindAttributes(GLint positionId, GLint normalId, GLint uvId)
+{
+  GLsizei stride = vertexStride;
+
+  glBindBuffer(GL_ARRAY_BUFFER, vertexBufferId->getGLuint());
+
+  if(positionId != -1)
+  {
+    glVertexAttribPointer(positionId, 3, GL_FLOAT, GL_FALSE, stride, 0);
+    glEnableVertexAttribArray(positionId);
+  }
+
+  if(normalId != -1)
+  {
+    glVertexAttribPointer(normalId, 3, GL_FLOAT, GL_FALSE, stride,
+      (GLvoid*)(3 * sizeof(GLfloat)));
+
+    glEnableVertexAttribArray(normalId);
+  }
+
+  if(uvId != -1)
+  {
+    glVertexAttribPointer(uvId, 2, GL_FLOAT, GL_FALSE, stride,
+      (GLvoid*)(6 * sizeof(GLfloat)));
+
+    glEnableVertexAttribArray(uvId);
+  }
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferId->getGLuint());
+}
+
+void Mesh::unbindAttributes(GLint positionId, GLint normalId, GLint uvId)
+{
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  if(positionId != -1)
+  {
+    glDisableVertexAttribArray(positionId);
+  }
+
+  if(normalId != -1)
+  {
+    glDisableVertexAttribArray(normalId);
+  }
+
+  if(uvId != -1)
+  {
+    glDisableVertexAttribArray(uvId);
+  }
+}
+
+GLuint Mesh::getVertexArray(GLint positionId, GLint normalId, GLint uvId)
+{
+  if(Application::context->vertexArrays == false)
+  {
+    return 0;
+  }
+
+  // Submeshes share the same buffers so only the attribute locations of the
+  // material decide which vertex array is needed. The buffer names survive a
+  // re-upload so the cached arrays never go stale.
+  for(size_t i = 0; i < vertexArrays.size(); i++)
+  {
+    MeshVertexArray& va = vertexArrays.at(i);
+
+    if(va.positionId == positionId && va.normalId == normalId && va.uvId == uvId)
     {
-      uvBufferId = uvBufferIds.at(submesh);
+      return va.id->getGLuint();
     }
-
-    glBindBuffer(GL_ARRAY_BUFFER, uvBufferId->getGLuint());
-    //glBufferData(GL_ARRAY_BUFFER, values.size() * sizeof(values[0]), &values[0], GL_STATIC_DRAW);
-    glBufferData(GL_ARRAY_BUFFER, values.size() * sizeof(values[0]), &values[0], GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
   }
+
+  MeshVertexArray va;
+  va.positionId = positionId;
+  va.normalId = normalId;
+  va.uvId = uvId;
+  va.id = gl::Uint::genVertexArray();
+
+  glBindVertexArray(va.id->getGLuint());
+  bindAttributes(positionId, normalId, uvId);
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+  vertexArrays.push_back(va);
+
+  return va.id->getGLuint();
 }
 
 void Mesh::setUv(std::vector<Vector2> uv)
 {
+  use();
+  path = "";
   this->uv = uv;
+  dirty = true;
 }
 
 void Mesh::setNormals(std::vector<Vector3> normals)
 {
+  use();
+  path = "";
   this->normals = normals;
+  dirty = true;
+}
+
+// Answered from the header of an attached file so that choosing a default
+// material does not copy the arrays out of it. Every vertex in a mesh file
+// has a normal and uv.
+bool Mesh::hasNormals()
+{
+  markUsed();
+
+  if(evicted == true)
+  {
+    reload();
+  }
+
+  if(file.get() != NULL)
+  {
+    return file->header->vertexCount > 0;
+  }
+
+  return normals.size() > 0;
+}
+
+bool Mesh::hasUv()
+{
+  markUsed();
+
+  if(evicted == true)
+  {
+    reload();
+  }
+
+  if(file.get() != NULL)
+  {
+    return file->header->vertexCount > 0;
+  }
+
+  return uv.size() > 0;
 }
 
 std::vector<Vector3>& Mesh::getVertices()
 {
+  use();
+
   return vertices;
 }
 
 std::vector<int>& Mesh::getTriangles(int submesh)
 {
+  use();
+
   return triangles.at(submesh);
 }
 
 std::vector<Vector2>& Mesh::getUv()
 {
+  use();
+
   return uv;
 }
 
 std::vector<Vector3>& Mesh::getNormals()
 {
+  use();
+
   return normals;
 }
 
 std::vector<Color>& Mesh::getColors()
 {
+  use();
+
   return colors;
 }
 
 void Mesh::recalculateBounds()
 {
+  use();
+
   if(vertices.size() < 1)
   {
     bounds = Bounds(Vector3(), Vector3());
+    return;
   }
 
   float minX = vertices.at(0).x; float maxX = vertices.at(0).x;
@@ -7,9 +7,9 @@
 #include "Bounds.h"
 #include "Color.h"
 #include "internal/CWrapper.h"
+#include "internal/ResourceCache.h"
 #include "internal/glmm.h"
-
-#include <GL/glew.h>
+#include "internal/OpenGl.h"
 
 #include <vector>
 #include <string>
@@ -22,16 +22,38 @@ namespace engine
 {
 
 class Resources;
+template<class T> class ResourceRequest;
 class MeshRenderer;
 class Graphics;
+class AnimatedMesh;
+
+namespace internal
+{
+  class MeshFile;
+}
 
-class Mesh : public Object
+class MeshVertexArray
+{
+public:
+  GLint positionId;
+  GLint normalId;
+  GLint uvId;
+  shared<gl::Uint> id;
+
+};
+
+class Mesh : public Object, public internal::EvictableResource
 {
   friend class mutiny::engine::Resources;
   friend class mutiny::engine::MeshRenderer;
   friend class mutiny::engine::Graphics;
+  friend class mutiny::engine::AnimatedMesh;
+  template<class T> friend class mutiny::engine::ResourceRequest;
 
 public:
+  Mesh();
+
+  void markDynamic();
   void recalculateNormals();
   void recalculateBounds();
 
@@ -59,12 +81,46 @@ private:
   std::vector<Vector3> normals;
   std::vector<Color> colors;
 
-  std::vector<shared<gl::Uint> > positionBufferIds;
-  std::vector<shared<gl::Uint> > uvBufferIds;
-  std::vector<shared<gl::Uint> > normalBufferIds;
+  shared<gl::Uint> vertexBufferId;
+  shared<gl::Uint> indexBufferId;
+  std::vector<int> submeshOffsets;
+  std::vector<int> submeshCounts;
+  GLsizei vertexStride;
+  size_t bufferSize;
+  GLenum indexType;
+  GLenum usage;
+  bool dirty;
+  std::vector<MeshVertexArray> vertexArrays;
 
   Bounds bounds;
 
+  // File the mesh was loaded from, kept while its data is unchanged so
+  // that an evicted mesh can be read back
+  std::string path;
+  bool evicted;
+
+  // Until its data is read or changed a loaded mesh is drawn straight from
+  // the arrays of its file rather than copies of them
+  shared<internal::MeshFile> file;
+
+  bool hasNormals();
+  bool hasUv();
+  void setFile(shared<internal::MeshFile> file);
+  void fill(internal::MeshFile* file);
+  void reload();
+  void use();
+  void prepare();
+  void upload();
+  void uploadFile();
+  void setVertexStride(GLsizei stride);
+  void bindAttributes(GLint positionId, GLint normalId, GLint uvId);
+  void unbindAttributes(GLint positionId, GLint normalId, GLint uvId);
+  GLuint getVertexArray(GLint positionId, GLint normalId, GLint uvId);
+
+  virtual size_t getResidentSize();
+  virtual bool canEvict();
+  virtual void evict();
+
 };
 
 }
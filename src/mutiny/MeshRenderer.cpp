@@ -21,7 +21,7 @@ namespace engine
 
 MeshRenderer::MeshRenderer()
 {
-
+  staticBatched = false;
 }
 
 MeshRenderer::~MeshRenderer()
@@ -31,6 +31,12 @@ MeshRenderer::~MeshRenderer()
 
 void MeshRenderer::render()
 {
+  // Geometry has been merged into a static batch which draws it instead
+  if(staticBatched == true)
+  {
+    return;
+  }
+
   ref<MeshFilter> meshFilter = getGameObject()->getComponent<MeshFilter>();
   ref<Mesh> mesh;
   ref<Transform> transform = getGameObject()->getTransform();
@@ -55,56 +61,67 @@ void MeshRenderer::render()
     return;
   }
 
+  ref<Camera> camera = Camera::getCurrent();
+  Matrix4x4 modelMat = transform->getLocalToWorldMatrix();
+  Bounds bounds = mesh->getBounds();
+  Bounds worldBounds = internal::Frustum::transformBounds(bounds, modelMat);
+
+  if(camera->frustum.testAabb(worldBounds) == false)
+  {
+    camera->culledCount++;
+    return;
+  }
+
+  camera->visibleCount++;
+
   // obtain left-handed coordinate system by multiplying a negative Z scale on ModelView matrix
 
-  Matrix4x4 viewMat = Matrix4x4::getTrs(
-    Camera::getCurrent()->getGameObject()->getTransform()->getPosition(),
-    Camera::getCurrent()->getGameObject()->getTransform()->getRotation(),
-    Vector3(1, 1, 1) * Vector3(1, 1, -1)
-  ).inverse();
+  Matrix4x4 cameraMat = camera->getGameObject()->getTransform()->getWorldToLocalMatrix();
+  Matrix4x4 viewMat = Matrix4x4::getIdentity().scale(Vector3(1, 1, -1)) * cameraMat;
+  Matrix4x4 normalMat = (viewMat * transform->getWorldToLocalMatrix()).transpose();
 
-  Matrix4x4 modelMat = Matrix4x4::getTrs(
-    transform->getPosition(),
-    transform->getRotation(),
-    Vector3(1, 1, 1) * Vector3(1, 1, 1)
-  );
+  // Distance along the view direction used to order draws in the queue
+  float depth = cameraMat.multiplyPoint(worldBounds.center).z;
 
   for(size_t i = 0; i < mesh->getSubmeshCount(); i++)
   {
-    ref<Material> material = getMaterial();
+    ref<Material> material = getSubmeshMaterial(mesh, i);
 
-    if(materials.size() > i)
+    for(size_t j = 0; j < material->getPassCount(); j++)
     {
-      material = materials.at(i);
+      Application::context->renderQueue->submit(material.get(), j, mesh.get(), i,
+        depth, modelMat, normalMat);
     }
+  }
+}
 
-    if(material.expired())
-    {
-      if(mesh->getNormals().size() > 0 && mesh->getUv().size() > 0)
-      {
-        material = Application::context->meshNormalTextureMaterial;
-        material->setMainTexture(Application::context->defaultTexture);
-      }
-      else if(mesh->getNormals().size() > 0)
-      {
-        material = Application::context->meshNormalMaterial;
-      }
-      else
-      {
-        material = Application::context->meshNormalMaterial;
-      }
-    }
+ref<Material> MeshRenderer::getSubmeshMaterial(ref<Mesh> mesh, int submesh)
+{
+  ref<Material> material = getMaterial();
 
-    material->setMatrix("in_Projection", Camera::getCurrent()->getProjectionMatrix());
-    material->setMatrix("in_View", viewMat);
-    material->setMatrix("in_NormalMatrix", (viewMat * modelMat.inverse()).transpose());
+  if((int)materials.size() > submesh)
+  {
+    material = materials.at(submesh);
+  }
 
-    for(size_t j = 0; j < material->getPassCount(); j++)
+  if(material.expired())
+  {
+    if(mesh->hasNormals() == true && mesh->hasUv() == true)
+    {
+      material = Application::context->meshNormalTextureMaterial;
+      material->setMainTexture(Application::context->defaultTexture);
+    }
+    else if(mesh->hasNormals() == true)
     {
-      material->setPass(j, material.get());
-      Graphics::drawMeshNow(mesh, modelMat, i);
+      material = Application::context->meshNormalMaterial;
+    }
+    else
+    {
+      material = Application::context->meshNormalMaterial;
     }
   }
+
+  return material;
 }
 
 void MeshRenderer::setMaterials(std::vector<ref<Material> > materials)
@@ -3,8 +3,7 @@
 
 #include "Component.h"
 #include "ref.h"
-
-#include <GL/glew.h>
+#include "internal/OpenGl.h"
 
 #include <memory>
 #include <vector>
@@ -18,10 +17,12 @@ namespace engine
 class Mesh;
 class GameObject;
 class Material;
+class StaticBatchingUtility;
 
 class MeshRenderer : public Component
 {
   friend class mutiny::engine::GameObject;
+  friend class mutiny::engine::StaticBatchingUtility;
 
 public:
   MeshRenderer();
@@ -34,8 +35,10 @@ public:
 
 private:
   virtual void render();
+  ref<Material> getSubmeshMaterial(ref<Mesh> mesh, int submesh);
 
   std::vector<ref<Material> > materials;
+  bool staticBatched;
 
 };
 
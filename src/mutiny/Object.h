@@ -13,11 +13,21 @@ namespace engine
 
 class Application;
 class GameObject;
+class Profiler;
+class StaticBatchingUtility;
+
+namespace internal
+{
+  class ResourceCache;
+}
 
 class Object : public enable_ref
 {
   friend class Application;
   friend class GameObject;
+  friend class Profiler;
+  friend class StaticBatchingUtility;
+  friend class mutiny::engine::internal::ResourceCache;
 
 public:
   static void dontDestroyOnLoad(ref<Object> object);
@@ -131,6 +131,8 @@ void ParticleRenderer::render()
     glEnableVertexAttribArray(uvAttribId);
   }
 
+  static int modelId = Shader::propertyToId("in_Model");
+
   glDisable(GL_DEPTH_TEST);
   for(size_t i = 0; i < emitter->particles.size(); i++)
   {
@@ -140,7 +142,7 @@ void ParticleRenderer::render()
     modelMat = modelMat.translate(axisMod);
     modelMat = modelMat.rotate(Vector3(0, 0, 180.0f));
 
-    material->setMatrix("in_Model", modelMat);
+    material->setMatrix(modelId, modelMat);
 
     material->setPass(0, material);
     glDrawArrays(GL_TRIANGLES, 0, 6);
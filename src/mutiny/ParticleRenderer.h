@@ -2,8 +2,7 @@
 #define MUTINY_ENGINE_PARTICLERENDERER_H
 
 #include "Component.h"
-
-#include <GL/glew.h>
+#include "internal/OpenGl.h"
 
 #include <memory>
 
@@ -0,0 +1,511 @@
+#include "Profiler.h"
+#include "Object.h"
+#include "Component.h"
+#include "Exception.h"
+#include "internal/platform.h"
+
+#ifdef USE_WINAPI
+  #include <windows.h>
+#else
+  #include <time.h>
+#endif
+
+#ifdef __GNUC__
+  #include <cxxabi.h>
+#endif
+
+#include <fstream>
+#include <cstdlib>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+bool Profiler::enabled = true;
+float Profiler::objectThreshold = 0.05f;
+std::vector<shared<ProfilerFrame> > Profiler::frames(120);
+int Profiler::head = 0;
+int Profiler::count = 0;
+int Profiler::frame = 0;
+shared<ProfilerFrame> Profiler::current;
+std::vector<int> Profiler::openSamples;
+std::vector<Object*> Profiler::openObjects;
+std::vector<const std::type_info*> Profiler::types;
+std::vector<std::string> Profiler::typeNames;
+bool Profiler::detail = false;
+int Profiler::detailInterval = 30;
+double Profiler::lastTime = 0;
+
+int ProfilerFrame::getFrame()
+{
+  return frame;
+}
+
+double ProfilerFrame::getStartTime()
+{
+  return startTime;
+}
+
+float ProfilerFrame::getDuration()
+{
+  return duration;
+}
+
+int ProfilerFrame::getSampleCount()
+{
+  return sampleCount;
+}
+
+ProfilerSample& ProfilerFrame::getSample(int index)
+{
+  if(index < 0 || index >= sampleCount)
+  {
+    throw Exception("Sample index out of range");
+  }
+
+  return samples.at(index);
+}
+
+float ProfilerFrame::getSampleTime(std::string name)
+{
+  float rtn = 0;
+
+  for(int i = 0; i < sampleCount; i++)
+  {
+    if(samples.at(i).name == name)
+    {
+      rtn += samples.at(i).duration;
+    }
+  }
+
+  return rtn;
+}
+
+int ProfilerFrame::getTypeSampleCount()
+{
+  return typeSamples.size();
+}
+
+ProfilerTypeSample& ProfilerFrame::getTypeSample(int index)
+{
+  return typeSamples.at(index);
+}
+
+float ProfilerFrame::getTypeSampleTime(std::string name)
+{
+  for(size_t i = 0; i < typeSamples.size(); i++)
+  {
+    if(typeSamples.at(i).name == name)
+    {
+      return typeSamples.at(i).duration;
+    }
+  }
+
+  return 0;
+}
+
+double Profiler::getTime()
+{
+#ifdef USE_WINAPI
+  static LARGE_INTEGER frequency = { 0 };
+  LARGE_INTEGER counter = { 0 };
+
+  if(frequency.QuadPart == 0)
+  {
+    QueryPerformanceFrequency(&frequency);
+  }
+
+  QueryPerformanceCounter(&counter);
+
+  return (double)counter.QuadPart * 1000.0 / (double)frequency.QuadPart;
+#else
+  timespec ts = { 0 };
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+#endif
+}
+
+void Profiler::setEnabled(bool enabled)
+{
+  Profiler::enabled = enabled;
+
+  // Anything half recorded is thrown away rather than left unbalanced
+  current.reset();
+  detail = false;
+  openSamples.clear();
+  openObjects.clear();
+}
+
+bool Profiler::isEnabled()
+{
+  return enabled;
+}
+
+void Profiler::setHistorySize(int frames)
+{
+  if(frames < 1)
+  {
+    throw Exception("History size must be at least one frame");
+  }
+
+  Profiler::frames.clear();
+  Profiler::frames.resize(frames);
+  head = 0;
+  count = 0;
+  current.reset();
+  detail = false;
+  openSamples.clear();
+  openObjects.clear();
+}
+
+void Profiler::setObjectThreshold(float milliseconds)
+{
+  objectThreshold = milliseconds;
+}
+
+void Profiler::setDetailInterval(int frames)
+{
+  if(frames < 1)
+  {
+    throw Exception("Detail interval must be at least one frame");
+  }
+
+  detailInterval = frames;
+}
+
+int Profiler::getFrameCount()
+{
+  return count;
+}
+
+ref<ProfilerFrame> Profiler::getFrame(int age)
+{
+  if(age < 0 || age >= count)
+  {
+    return ref<ProfilerFrame>();
+  }
+
+  int index = head - 1 - age;
+
+  if(index < 0)
+  {
+    index += frames.size();
+  }
+
+  return frames.at(index);
+}
+
+void Profiler::beginFrame()
+{
+  if(enabled == false)
+  {
+    return;
+  }
+
+  if(current.get() != NULL)
+  {
+    endFrame();
+  }
+
+  // The oldest frame is about to be recycled
+  if(count == (int)frames.size())
+  {
+    count--;
+  }
+
+  shared<ProfilerFrame>& slot = frames.at(head);
+
+  if(slot.get() == NULL)
+  {
+    slot.reset(new ProfilerFrame());
+  }
+
+  current = slot;
+  current->frame = frame;
+  current->startTime = getTime();
+  current->duration = 0;
+  current->sampleCount = 0;
+
+  for(size_t i = 0; i < current->typeSamples.size(); i++)
+  {
+    current->typeSamples.at(i).duration = 0;
+    current->typeSamples.at(i).calls = 0;
+  }
+
+  // Phases are always recorded but the per object and per component
+  // breakdown costs a clock read per component so may be thinned out.
+  detail = frame % detailInterval == 0;
+  frame++;
+}
+
+void Profiler::endFrame()
+{
+  if(current.get() == NULL)
+  {
+    return;
+  }
+
+  double time = getTime();
+
+  while(openSamples.size() > 0)
+  {
+    popSample(time);
+  }
+
+  openObjects.clear();
+  current->duration = time - current->startTime;
+  current.reset();
+  detail = false;
+
+  head++;
+
+  if(head >= (int)frames.size())
+  {
+    head = 0;
+  }
+
+  if(count < (int)frames.size())
+  {
+    count++;
+  }
+}
+
+int Profiler::pushSample(double time)
+{
+  int index = current->sampleCount;
+
+  if(index >= (int)current->samples.size())
+  {
+    current->samples.push_back(ProfilerSample());
+  }
+
+  ProfilerSample& sample = current->samples.at(index);
+  sample.depth = openSamples.size();
+  sample.start = time - current->startTime;
+  sample.duration = 0;
+  current->sampleCount++;
+  openSamples.push_back(index);
+
+  return index;
+}
+
+void Profiler::popSample(double time)
+{
+  ProfilerSample& sample = current->samples.at(openSamples.back());
+  sample.duration = time - current->startTime - sample.start;
+  openSamples.pop_back();
+}
+
+void Profiler::beginSample(const char* name)
+{
+  if(current.get() == NULL)
+  {
+    return;
+  }
+
+  int index = pushSample(getTime());
+  current->samples.at(index).name = name;
+}
+
+void Profiler::beginSample(const std::string& name)
+{
+  beginSample(name.c_str());
+}
+
+void Profiler::endSample()
+{
+  if(current.get() == NULL || openSamples.size() < 1)
+  {
+    return;
+  }
+
+  popSample(getTime());
+}
+
+void Profiler::beginObjectSample(Object* object)
+{
+  if(detail == false)
+  {
+    return;
+  }
+
+  lastTime = getTime();
+  pushSample(lastTime);
+  openObjects.push_back(object);
+}
+
+void Profiler::endObjectSample()
+{
+  if(detail == false || openObjects.size() < 1)
+  {
+    return;
+  }
+
+  int index = openSamples.back();
+  Object* object = openObjects.back();
+
+  // The owning GameObject has just timed its last component so that
+  // reading is reused rather than querying the clock again.
+  popSample(lastTime);
+  openObjects.pop_back();
+
+  ProfilerSample& sample = current->samples.at(index);
+
+  // Cheap objects with nothing nested inside them are dropped so that a
+  // scene of thousands of idle objects does not flood the history. The
+  // name is only copied once the sample is known to be kept.
+  if(sample.duration < objectThreshold && index == current->sampleCount - 1)
+  {
+    current->sampleCount--;
+    return;
+  }
+
+  sample.name = object->name;
+}
+
+int Profiler::findType(const std::type_info* type)
+{
+  for(size_t i = 0; i < types.size(); i++)
+  {
+    if(types.at(i) == type)
+    {
+      return i;
+    }
+  }
+
+  for(size_t i = 0; i < types.size(); i++)
+  {
+    if(*types.at(i) == *type)
+    {
+      return i;
+    }
+  }
+
+  std::string name = type->name();
+
+#ifdef __GNUC__
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(type->name(), NULL, NULL, &status);
+
+  if(demangled != NULL)
+  {
+    if(status == 0)
+    {
+      name = demangled;
+    }
+
+    free(demangled);
+  }
+#endif
+
+  types.push_back(type);
+  typeNames.push_back(name);
+
+  return types.size() - 1;
+}
+
+void Profiler::sampleComponent(Component* component)
+{
+  double time = getTime();
+  int type = findType(&typeid(*component));
+
+  while((int)current->typeSamples.size() <= type)
+  {
+    ProfilerTypeSample sample;
+    sample.name = typeNames.at(current->typeSamples.size());
+    sample.duration = 0;
+    sample.calls = 0;
+    current->typeSamples.push_back(sample);
+  }
+
+  ProfilerTypeSample& sample = current->typeSamples.at(type);
+  sample.duration += time - lastTime;
+  sample.calls++;
+  lastTime = time;
+}
+
+static std::string escapeJson(std::string input)
+{
+  std::string rtn;
+
+  for(size_t i = 0; i < input.length(); i++)
+  {
+    char c = input.at(i);
+
+    if(c == '"' || c == '\\')
+    {
+      rtn += '\\';
+      rtn += c;
+    }
+    else if((unsigned char)c < 0x20)
+    {
+      rtn += ' ';
+    }
+    else
+    {
+      rtn += c;
+    }
+  }
+
+  return rtn;
+}
+
+void Profiler::dumpChromeTrace(std::string path)
+{
+  std::ofstream file(path.c_str());
+
+  if(file.is_open() == false)
+  {
+    throw Exception("Failed to open '" + path + "' for writing");
+  }
+
+  file.precision(3);
+  file << std::fixed;
+  file << "{\"traceEvents\":[";
+
+  bool first = true;
+
+  for(int age = count - 1; age >= 0; age--)
+  {
+    ref<ProfilerFrame> pf = getFrame(age);
+    double start = pf->startTime * 1000.0;
+
+    if(first == false) file << ",";
+    first = false;
+
+    file << "\n{\"name\":\"Frame " << pf->frame << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+      << ",\"ts\":" << start << ",\"dur\":" << pf->duration * 1000.0 << "}";
+
+    for(int i = 0; i < pf->sampleCount; i++)
+    {
+      ProfilerSample& sample = pf->samples.at(i);
+
+      file << ",\n{\"name\":\"" << escapeJson(sample.name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+        << ",\"ts\":" << start + sample.start * 1000.0
+        << ",\"dur\":" << sample.duration * 1000.0 << "}";
+    }
+
+    if(pf->typeSamples.size() > 0)
+    {
+      file << ",\n{\"name\":\"Components\",\"ph\":\"C\",\"pid\":1,\"ts\":" << start << ",\"args\":{";
+
+      for(size_t i = 0; i < pf->typeSamples.size(); i++)
+      {
+        if(i > 0) file << ",";
+        file << "\"" << escapeJson(pf->typeSamples.at(i).name) << "\":" << pf->typeSamples.at(i).duration;
+      }
+
+      file << "}}";
+    }
+  }
+
+  file << "\n]}\n";
+}
+
+}
+
+}
+
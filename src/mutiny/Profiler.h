@@ -0,0 +1,122 @@
+#ifndef MUTINY_ENGINE_PROFILER_H
+#define MUTINY_ENGINE_PROFILER_H
+
+#include "ref.h"
+
+#include <string>
+#include <vector>
+#include <typeinfo>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+class Application;
+class GameObject;
+class Object;
+class Component;
+class Profiler;
+
+class ProfilerSample
+{
+public:
+  std::string name;
+  int depth;
+  float start;
+  float duration;
+
+};
+
+class ProfilerTypeSample
+{
+public:
+  std::string name;
+  float duration;
+  int calls;
+
+};
+
+class ProfilerFrame : public enable_ref
+{
+  friend class mutiny::engine::Profiler;
+
+public:
+  int getFrame();
+  double getStartTime();
+  float getDuration();
+  int getSampleCount();
+  ProfilerSample& getSample(int index);
+  float getSampleTime(std::string name);
+  int getTypeSampleCount();
+  ProfilerTypeSample& getTypeSample(int index);
+  float getTypeSampleTime(std::string name);
+
+private:
+  int frame;
+  double startTime;
+  float duration;
+  std::vector<ProfilerSample> samples;
+  int sampleCount;
+  std::vector<ProfilerTypeSample> typeSamples;
+
+};
+
+class Profiler
+{
+  friend class mutiny::engine::Application;
+  friend class mutiny::engine::GameObject;
+
+public:
+  static void setEnabled(bool enabled);
+  static bool isEnabled();
+  static void setHistorySize(int frames);
+  static void setObjectThreshold(float milliseconds);
+  static void setDetailInterval(int frames);
+
+  // Takes the name as a pointer so that nothing is built when profiling
+  // is off
+  static void beginSample(const char* name);
+  static void beginSample(const std::string& name);
+  static void endSample();
+
+  static int getFrameCount();
+  static ref<ProfilerFrame> getFrame(int age);
+  static void dumpChromeTrace(std::string path);
+
+  static double getTime();
+
+private:
+  static bool enabled;
+  static float objectThreshold;
+  static std::vector<shared<ProfilerFrame> > frames;
+  static int head;
+  static int count;
+  static int frame;
+  static shared<ProfilerFrame> current;
+  static std::vector<int> openSamples;
+  static std::vector<Object*> openObjects;
+  static std::vector<const std::type_info*> types;
+  static std::vector<std::string> typeNames;
+  static bool detail;
+  static int detailInterval;
+  static double lastTime;
+
+  static void beginFrame();
+  static void endFrame();
+  static void beginObjectSample(Object* object);
+  static void endObjectSample();
+  static void sampleComponent(Component* component);
+  static int pushSample(double time);
+  static void popSample(double time);
+  static int findType(const std::type_info* type);
+
+};
+
+}
+
+}
+
+#endif
+
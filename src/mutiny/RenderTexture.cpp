@@ -3,8 +3,7 @@
 #include "Application.h"
 #include "Screen.h"
 #include "Debug.h"
-
-#include <GL/glew.h>
+#include "internal/OpenGl.h"
 
 #include <memory>
 #include <functional>
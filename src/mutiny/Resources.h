@@ -5,12 +5,12 @@
 #include "Material.h"
 #include "Application.h"
 #include "Object.h"
+#include "internal/AsyncLoader.h"
+#include "internal/TypeId.h"
 
 #include <memory>
 #include <string>
 #include <vector>
-#include <typeinfo>
-#include <sstream>
 #include <iostream>
 
 namespace mutiny
@@ -21,50 +21,83 @@ namespace engine
 
 class Object;
 class Application;
+class Texture2d;
+class Mesh;
+
+// Handle to a resource being loaded by Resources::loadAsync. The asset is
+// valid once isDone returns true, unless the resource failed to load.
+template<class T> class ResourceRequest : public internal::AsyncJob
+{
+  friend class Resources;
+
+public:
+  bool isDone()
+  {
+    return done;
+  }
+
+  ref<T> getAsset()
+  {
+    return asset;
+  }
+
+private:
+  std::string path;
+  std::vector<std::string> paths;
+
+  // Filled in by decode for types that can be read away from the main
+  // thread. Everything else is loaded in full by upload.
+  shared<void> data;
+  shared<T> object;
+  std::string foundPath;
+
+  ref<T> asset;
+  bool done;
+
+  ResourceRequest()
+  {
+    done = false;
+  }
+
+  virtual void decode()
+  {
+
+  }
+
+  virtual void upload();
+
+};
+
+template<> void ResourceRequest<Texture2d>::decode();
+template<> void ResourceRequest<Texture2d>::upload();
+template<> void ResourceRequest<Mesh>::decode();
+template<> void ResourceRequest<Mesh>::upload();
 
 class Resources
 {
   friend class mutiny::engine::Application;
+  template<class T> friend class mutiny::engine::ResourceRequest;
 
 public:
   template<class T> static ref<T> load(std::string path)
   {
-    std::stringstream ss;
-    ss << path << "_" << typeid(T).name();
+    ref<T> t = find<T>(path);
 
-    for(size_t i = 0; i < Application::context->paths.size(); i++)
+    if(t.valid())
     {
-      if(ss.str() == Application::context->paths.at(i))
-      {
-        return ref<T>(dynamic_cast<T*>(Application::context->objects.at(i).get()));
-      }
+      return t;
     }
 
-    ref<T> t;
-
-    // Game specific resources
-    try
-    {
-      t = T::load(Application::getDataPath() + "/" + path);
-    }
-    catch(std::exception& e){}
-
-    // Internal engine files
-    if(t.expired())
-    {
-      try
-      {
-        t = T::load(Application::getEngineDataPath() + "/" + path);
-      }
-      catch(std::exception& e){}
-    }
+    // Game data first, then engine data, then the path as given. Only
+    // the roots known to hold the file are tried.
+    std::vector<std::string> paths;
+    Application::context->resourceIndex->resolve(path, paths);
 
-    // Absolute path
-    if(t.expired())
+    for(size_t i = 0; i < paths.size() && t.expired(); i++)
     {
       try
       {
-        t = T::load(path);
+        t = T::load(paths.at(i));
       }
       catch(std::exception& e){}
     }
@@ -76,16 +109,85 @@ public:
       return NULL;
     }
 
-    Application::context->paths.push_back(ss.str());
-    Application::context->objects.push_back(shared<T>(t.get()));
+    add(path, shared<T>(t.get()));
 
     //std::cout << "Loading: " << path << "... Success" << std::endl;
 
     return t;
   }
 
+  // Textures and meshes are read and decoded on loader threads and only
+  // handed to GL on the main thread, a few each frame. Other types are
+  // loaded as by load but from the frame update rather than the caller.
+  template<class T> static shared<ResourceRequest<T> > loadAsync(std::string path)
+  {
+    shared<ResourceRequest<T> > rtn(new ResourceRequest<T>());
+
+    rtn->path = path;
+    rtn->asset = find<T>(path);
+
+    if(rtn->asset.valid())
+    {
+      rtn->done = true;
+
+      return rtn;
+    }
+
+    Application::context->resourceIndex->resolve(path, rtn->paths);
+
+    Application::context->asyncLoader->add(rtn);
+
+    return rtn;
+  }
+
+  // Rescans the data directories for files added or removed since they
+  // were first indexed
+  static void refresh()
+  {
+    Application::context->resourceIndex->refresh();
+  }
+
+  // Bytes of texture and mesh data loaded resources may keep resident.
+  // Data not used in the last frame is released to stay under it and read
+  // back from file when next used. Zero, the default, releases nothing.
+  static void setMemoryBudget(size_t bytes)
+  {
+    Application::context->resourceCache->setBudget(bytes);
+  }
+
+  static size_t getMemoryBudget()
+  {
+    return Application::context->resourceCache->getBudget();
+  }
+
+  static size_t getMemoryUsage()
+  {
+    return Application::context->resourceCache->getUsage();
+  }
+
+private:
+  template<class T> static ref<T> find(std::string& path)
+  {
+    Object* object = Application::context->resourceCache->find(
+      internal::TypeId::get<T>(), path);
+
+    return ref<T>(static_cast<T*>(object));
+  }
+
+  template<class T> static void add(std::string& path, shared<T> t)
+  {
+    Application::context->resourceCache->add(internal::TypeId::get<T>(),
+      path, t);
+  }
+
 };
 
+template<class T> void ResourceRequest<T>::upload()
+{
+  asset = Resources::load<T>(path);
+  done = true;
+}
+
 }
 
 }
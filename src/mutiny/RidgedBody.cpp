@@ -31,7 +31,7 @@ RidgedBody::~RidgedBody()
 void RidgedBody::update()
 {
   getGameObject()->getTransform()->translate(Vector3(0, -10, 0) * Time::getDeltaTime());
-  std::vector<ref<MeshCollider> > collidableObjects = GameObject::findObjectsOfType<MeshCollider>();
+  GameObject::findObjectsOfType<MeshCollider>(collidableObjects);
 
   for(size_t i = 0; i < collidableObjects.size(); i++)
   {
@@ -40,8 +40,7 @@ void RidgedBody::update()
     ref<Mesh> mesh = meshCollider->getMesh();
     std::vector<Vector3>& vertices = mesh->getVertices();
 
-    Matrix4x4 colliderItrs = Matrix4x4::getTrs(meshCollider->getGameObject()->getTransform()->getPosition(),
-     meshCollider->getGameObject()->getTransform()->getRotation(), Vector3(1, 1, 1)).inverse();
+    Matrix4x4 colliderItrs = meshCollider->getGameObject()->getTransform()->getWorldToLocalMatrix();
 
     position = colliderItrs * position;
     //Vector3 size = Bounds(Vector3(), Vector3(1, 1, 1)).extents;
@@ -49,16 +48,21 @@ void RidgedBody::update()
 
     bool isColliding = false;
 
-    for(size_t v = 0; v < vertices.size(); v+=3)
+    for(size_t s = 0; s < mesh->getSubmeshCount() && isColliding == false; s++)
     {
-      Vector3 a = vertices.at(v);
-      Vector3 b = vertices.at(v+1);
-      Vector3 c = vertices.at(v+2);
+      std::vector<int>& triangles = mesh->getTriangles(s);
 
-      if(colliding(position, size, a, b, c) == true)
+      for(size_t v = 0; v < triangles.size(); v+=3)
       {
-        isColliding = true;
-        break;
+        Vector3 a = vertices.at(triangles.at(v));
+        Vector3 b = vertices.at(triangles.at(v+1));
+        Vector3 c = vertices.at(triangles.at(v+2));
+
+        if(colliding(position, size, a, b, c) == true)
+        {
+          isColliding = true;
+          break;
+        }
       }
     }
 
@@ -13,6 +13,7 @@ namespace engine
 {
 
 class Vector3;
+class MeshCollider;
 
 class RidgedBody : public Component
 {
@@ -26,6 +27,7 @@ private:
   bool colliding(Vector3& center, Vector3& half, Vector3& a, Vector3& b, Vector3& c);
 
   std::vector<Collision> collisions;
+  std::vector<ref<MeshCollider> > collidableObjects;
 
 };
 
@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <functional>
+#include <cstring>
 
 #include <iostream>
 #include <fstream>
@@ -17,6 +18,97 @@ namespace mutiny
 namespace engine
 {
 
+std::map<std::string, int> Shader::propertyIds;
+std::vector<std::string> Shader::propertyNames;
+
+ShaderUniform::ShaderUniform()
+{
+  owner = NULL;
+  count = 0;
+}
+
+int Shader::propertyToId(std::string name)
+{
+  std::map<std::string, int>::iterator it = propertyIds.find(name);
+
+  if(it != propertyIds.end())
+  {
+    return it->second;
+  }
+
+  int id = propertyNames.size();
+  propertyIds[name] = id;
+  propertyNames.push_back(name);
+
+  return id;
+}
+
+std::string Shader::idToProperty(int id)
+{
+  return propertyNames.at(id);
+}
+
+bool Shader::isResident(GLint location, Material* owner)
+{
+  std::map<GLint, ShaderUniform>::iterator it = uniforms.find(location);
+
+  if(it == uniforms.end())
+  {
+    return false;
+  }
+
+  return it->second.owner == owner;
+}
+
+void Shader::setUniform(GLint location, GLenum type, const float* values, Material* owner)
+{
+  if(location < 0)
+  {
+    return;
+  }
+
+  int count = 1;
+
+  if(type == GL_FLOAT_MAT4)
+  {
+    count = 16;
+  }
+  else if(type == GL_FLOAT_VEC2)
+  {
+    count = 2;
+  }
+
+  // Uniforms belong to the program so a value already resident from any
+  // earlier upload does not need sending again
+  ShaderUniform& uniform = uniforms[location];
+  uniform.owner = owner;
+
+  if(uniform.count == count && memcmp(uniform.values, values, count * sizeof(float)) == 0)
+  {
+    return;
+  }
+
+  uniform.count = count;
+  memcpy(uniform.values, values, count * sizeof(float));
+
+  if(type == GL_FLOAT_MAT4)
+  {
+    glUniformMatrix4fv(location, 1, GL_FALSE, values);
+  }
+  else if(type == GL_FLOAT_VEC2)
+  {
+    glUniform2f(location, values[0], values[1]);
+  }
+  else if(type == GL_SAMPLER_2D)
+  {
+    glUniform1i(location, (GLint)values[0]);
+  }
+  else
+  {
+    glUniform1f(location, values[0]);
+  }
+}
+
 void Shader::deleteVertexArray(GLuint id)
 {
   glDeleteVertexArrays(1, &id);
@@ -76,6 +168,13 @@ Shader::Shader(std::string vertContents, std::string fragContents)
   const char* fragSrc = NULL;
   GLint isCompiled = GL_FALSE;
 
+  // Built-in mesh shaders take their matrices as per-instance attributes
+  // only where the context can draw instanced with that many attributes
+  if(Application::context->instancing == true)
+  {
+    vertContents = "#define MUTINY_INSTANCING\n" + vertContents;
+  }
+
   vertexShaderId = gl::Uint::createVertexShader();
   vertSrc = vertContents.c_str();
   glShaderSource(vertexShaderId->getGLuint(), 1, &vertSrc, NULL);
@@ -119,6 +218,10 @@ Shader::Shader(std::string vertContents, std::string fragContents)
   programId = gl::Uint::createProgram();
   glAttachShader(programId->getGLuint(), vertexShaderId->getGLuint());
   glAttachShader(programId->getGLuint(), fragmentShaderId->getGLuint());
+
+  // Some drivers will not draw unless attribute zero is an array so keep the
+  // position there rather than letting a constant instance attribute take it
+  glBindAttribLocation(programId->getGLuint(), 0, "in_Position");
   glLinkProgram(programId->getGLuint());
 
   GLint isLinked = 0;
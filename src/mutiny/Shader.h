@@ -4,10 +4,11 @@
 #include "ref.h"
 #include "Object.h"
 #include "internal/glmm.h"
-
-#include <GL/glew.h>
+#include "internal/OpenGl.h"
 
 #include <string>
+#include <vector>
+#include <map>
 #include <memory>
 
 namespace mutiny
@@ -24,16 +25,41 @@ class Gui;
 class Graphics;
 class Resources;
 
+namespace internal
+{
+  class RenderQueue;
+}
+
+class ShaderUniform
+{
+public:
+  ShaderUniform();
+
+  Material* owner;
+  int count;
+  float values[16];
+
+};
+
 class Shader : public Object
 {
+  friend class gl::Uint;
   friend class mutiny::engine::Material;
   friend class mutiny::engine::MeshRenderer;
   friend class mutiny::engine::Gui;
   friend class mutiny::engine::Graphics;
   friend class mutiny::engine::ParticleRenderer;
   friend class mutiny::engine::Resources;
+  friend class mutiny::engine::internal::RenderQueue;
+
+public:
+  static int propertyToId(std::string name);
 
 private:
+  static std::map<std::string, int> propertyIds;
+  static std::vector<std::string> propertyNames;
+
+  static std::string idToProperty(int id);
   static void deleteVertexArray(GLuint id);
   static ref<Shader> load(std::string path);
 
@@ -42,6 +68,10 @@ private:
   shared<gl::Uint> vertexShaderId;
   shared<gl::Uint> fragmentShaderId;
   shared<gl::Uint> programId;
+  std::map<GLint, ShaderUniform> uniforms;
+
+  bool isResident(GLint location, Material* owner);
+  void setUniform(GLint location, GLenum type, const float* values, Material* owner);
 
   static shared<Shader> create(std::string vertContents, std::string fragContents);
 
@@ -0,0 +1,395 @@
+#include "StaticBatchingUtility.h"
+#include "Application.h"
+#include "GameObject.h"
+#include "MeshRenderer.h"
+#include "MeshFilter.h"
+#include "Mesh.h"
+#include "Material.h"
+#include "Transform.h"
+#include "Matrix4x4.h"
+#include "Vector3.h"
+#include "Vector2.h"
+#include "Bounds.h"
+#include "internal/Frustum.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+const float StaticBatchingUtility::CHUNK_SIZE = 50.0f;
+
+struct PendingBatch
+{
+  Material* material;
+  int layer;
+  bool destroyOnLoad;
+  int chunkX;
+  int chunkY;
+  int chunkZ;
+
+  std::vector<Vector3> vertices;
+  std::vector<Vector3> normals;
+  std::vector<Vector2> uv;
+  std::vector<int> triangles;
+  std::vector<ref<MeshRenderer> > renderers;
+  std::vector<Matrix4x4> matrices;
+};
+
+static void emitBatch(PendingBatch& batch,
+  std::vector<shared<StaticBatch> >& staticBatches)
+{
+  if(batch.triangles.size() < 1)
+  {
+    return;
+  }
+
+  shared<Mesh> mesh(new Mesh());
+  mesh->setVertices(batch.vertices);
+  mesh->setNormals(batch.normals);
+  mesh->setUv(batch.uv);
+  mesh->setTriangles(batch.triangles, 0);
+  mesh->setName("Static Batch");
+
+  // The combined object is deliberately not flagged static so a later
+  // combine() does not try to batch it a second time.
+  ref<GameObject> gameObject = GameObject::create("Static Batch");
+  gameObject->setLayer(batch.layer);
+  gameObject->addComponent<MeshFilter>()->setMesh(mesh);
+  gameObject->addComponent<MeshRenderer>()->setMaterial(batch.material);
+
+  if(batch.destroyOnLoad == false)
+  {
+    Object::dontDestroyOnLoad(gameObject);
+    Object::dontDestroyOnLoad(mesh.get());
+  }
+
+  shared<StaticBatch> staticBatch(new StaticBatch());
+  staticBatch->mesh = mesh;
+  staticBatch->gameObject = gameObject;
+  staticBatch->destroyOnLoad = batch.destroyOnLoad;
+  staticBatch->renderers.swap(batch.renderers);
+  staticBatch->matrices.swap(batch.matrices);
+  staticBatches.push_back(staticBatch);
+
+  batch.vertices.clear();
+  batch.normals.clear();
+  batch.uv.clear();
+  batch.triangles.clear();
+}
+
+static bool isDestroyOnLoad(const shared<StaticBatch>& batch)
+{
+  return batch->destroyOnLoad;
+}
+
+void StaticBatchingUtility::combine()
+{
+  std::vector<ref<MeshRenderer> > renderers =
+    GameObject::findObjectsOfType<MeshRenderer>();
+
+  combine(renderers);
+}
+
+void StaticBatchingUtility::combine(ref<GameObject> root)
+{
+  std::vector<ref<MeshRenderer> > renderers;
+
+  collect(root, renderers);
+  combine(renderers);
+}
+
+void StaticBatchingUtility::collect(ref<GameObject> gameObject,
+  std::vector<ref<MeshRenderer> >& renderers)
+{
+  ref<MeshRenderer> meshRenderer = gameObject->getComponent<MeshRenderer>();
+
+  if(meshRenderer.valid())
+  {
+    renderers.push_back(meshRenderer);
+  }
+
+  ref<Transform> transform = gameObject->getTransform();
+
+  for(int i = 0; i < transform->getChildCount(); i++)
+  {
+    collect(transform->getChild(i)->getGameObject(), renderers);
+  }
+}
+
+void StaticBatchingUtility::combine(std::vector<ref<MeshRenderer> >& renderers)
+{
+  std::vector<PendingBatch> batches;
+
+  for(size_t r = 0; r < renderers.size(); r++)
+  {
+    ref<MeshRenderer> renderer = renderers.at(r);
+    ref<GameObject> gameObject = renderer->getGameObject();
+
+    if(renderer->staticBatched == true || renderer->destroyed == true ||
+      gameObject->destroyed == true || gameObject->getStatic() == false ||
+      gameObject->getActive() == false)
+    {
+      continue;
+    }
+
+    ref<MeshFilter> meshFilter = gameObject->getComponent<MeshFilter>();
+
+    if(meshFilter.expired() || meshFilter->getMesh().expired())
+    {
+      continue;
+    }
+
+    ref<Mesh> mesh = meshFilter->getMesh();
+    ref<Transform> transform = gameObject->getTransform();
+    Matrix4x4 modelMat = transform->getLocalToWorldMatrix();
+    Matrix4x4 normalMat = transform->getWorldToLocalMatrix().transpose();
+
+    Bounds bounds = mesh->getBounds();
+    Bounds worldBounds = internal::Frustum::transformBounds(bounds, modelMat);
+    int chunkX = (int)floor(worldBounds.center.x / CHUNK_SIZE);
+    int chunkY = (int)floor(worldBounds.center.y / CHUNK_SIZE);
+    int chunkZ = (int)floor(worldBounds.center.z / CHUNK_SIZE);
+
+    std::vector<Vector3>& vertices = mesh->getVertices();
+    std::vector<Vector3>& normals = mesh->getNormals();
+    std::vector<Vector2>& uv = mesh->getUv();
+
+    for(int s = 0; s < mesh->getSubmeshCount(); s++)
+    {
+      ref<Material> material = renderer->getSubmeshMaterial(mesh, s);
+      PendingBatch* batch = NULL;
+
+      for(size_t i = 0; i < batches.size(); i++)
+      {
+        PendingBatch& b = batches.at(i);
+
+        if(b.material == material.get() && b.layer == gameObject->getLayer() &&
+          b.destroyOnLoad == gameObject->destroyOnLoad &&
+          b.chunkX == chunkX && b.chunkY == chunkY && b.chunkZ == chunkZ)
+        {
+          batch = &b;
+          break;
+        }
+      }
+
+      if(batch == NULL)
+      {
+        batches.push_back(PendingBatch());
+        batch = &batches.back();
+        batch->material = material.get();
+        batch->layer = gameObject->getLayer();
+        batch->destroyOnLoad = gameObject->destroyOnLoad;
+        batch->chunkX = chunkX;
+        batch->chunkY = chunkY;
+        batch->chunkZ = chunkZ;
+      }
+
+      std::vector<int>& triangles = mesh->getTriangles(s);
+
+      // Only copy the vertices this submesh references so meshes split
+      // across several materials are not duplicated into every batch.
+      std::vector<int> remap(vertices.size(), -1);
+      size_t used = 0;
+
+      for(size_t i = 0; i < triangles.size(); i++)
+      {
+        if(remap.at(triangles.at(i)) == -1)
+        {
+          remap.at(triangles.at(i)) = 0;
+          used++;
+        }
+      }
+
+      // A submesh too large for 16-bit indices on its own still goes into
+      // a batch of its own; Mesh switches to 32-bit indices when uploading.
+      if(batch->vertices.size() > 0 &&
+        batch->vertices.size() + used > MAX_BATCH_VERTICES)
+      {
+        emitBatch(*batch, Application::context->staticBatches);
+      }
+
+      if(batch->renderers.size() < 1 ||
+        batch->renderers.back().get() != renderer.get())
+      {
+        batch->renderers.push_back(renderer);
+        batch->matrices.push_back(modelMat);
+      }
+
+      std::fill(remap.begin(), remap.end(), -1);
+
+      for(size_t i = 0; i < triangles.size(); i++)
+      {
+        int index = triangles.at(i);
+
+        if(remap.at(index) == -1)
+        {
+          remap.at(index) = batch->vertices.size();
+          batch->vertices.push_back(modelMat.multiplyPoint(vertices.at(index)));
+
+          if((int)normals.size() > index)
+          {
+            batch->normals.push_back(
+              normalMat.multiplyVector(normals.at(index)).getNormalized());
+          }
+          else
+          {
+            batch->normals.push_back(Vector3());
+          }
+
+          if((int)uv.size() > index)
+          {
+            batch->uv.push_back(uv.at(index));
+          }
+          else
+          {
+            batch->uv.push_back(Vector2());
+          }
+        }
+
+        batch->triangles.push_back(remap.at(index));
+      }
+    }
+
+    renderer->staticBatched = true;
+  }
+
+  for(size_t i = 0; i < batches.size(); i++)
+  {
+    emitBatch(batches.at(i), Application::context->staticBatches);
+  }
+}
+
+bool StaticBatchingUtility::isStale(StaticBatch* batch)
+{
+  for(size_t i = 0; i < batch->renderers.size(); i++)
+  {
+    ref<MeshRenderer> renderer = batch->renderers.at(i);
+
+    if(renderer.expired() || renderer->destroyed == true)
+    {
+      return true;
+    }
+
+    ref<GameObject> gameObject = renderer->getGameObject();
+
+    if(gameObject->destroyed == true || gameObject->getStatic() == false ||
+      gameObject->getActive() == false)
+    {
+      return true;
+    }
+
+    Matrix4x4 modelMat = gameObject->getTransform()->getLocalToWorldMatrix();
+
+    if(memcmp(modelMat.getValue(), batch->matrices.at(i).getValue(),
+      sizeof(float) * 16) != 0)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool StaticBatchingUtility::contains(StaticBatch* batch, MeshRenderer* renderer)
+{
+  for(size_t i = 0; i < batch->renderers.size(); i++)
+  {
+    if(batch->renderers.at(i).get() == renderer)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void StaticBatchingUtility::update()
+{
+  std::vector<shared<StaticBatch> >& batches = Application::context->staticBatches;
+  std::vector<shared<StaticBatch> > stale;
+
+  for(size_t i = 0; i < batches.size(); i++)
+  {
+    if(isStale(batches.at(i).get()) == true)
+    {
+      stale.push_back(batches.at(i));
+      batches.at(i) = batches.back();
+      batches.pop_back();
+      i--;
+    }
+  }
+
+  if(stale.size() < 1)
+  {
+    return;
+  }
+
+  // A renderer whose submeshes went into several batches has to leave all
+  // of them or it would be drawn both on its own and as part of a batch.
+  for(size_t s = 0; s < stale.size(); s++)
+  {
+    for(size_t r = 0; r < stale.at(s)->renderers.size(); r++)
+    {
+      MeshRenderer* renderer = stale.at(s)->renderers.at(r).get();
+
+      if(renderer == NULL)
+      {
+        continue;
+      }
+
+      for(size_t i = 0; i < batches.size(); i++)
+      {
+        if(contains(batches.at(i).get(), renderer) == true)
+        {
+          stale.push_back(batches.at(i));
+          batches.at(i) = batches.back();
+          batches.pop_back();
+          i--;
+        }
+      }
+    }
+  }
+
+  std::vector<ref<MeshRenderer> > renderers;
+
+  for(size_t s = 0; s < stale.size(); s++)
+  {
+    if(stale.at(s)->gameObject.valid())
+    {
+      Object::destroy(stale.at(s)->gameObject);
+    }
+
+    for(size_t r = 0; r < stale.at(s)->renderers.size(); r++)
+    {
+      ref<MeshRenderer> renderer = stale.at(s)->renderers.at(r);
+
+      if(renderer.valid())
+      {
+        renderer->staticBatched = false;
+        renderers.push_back(renderer);
+      }
+    }
+  }
+
+  // Whatever is still static and active is combined again in place.
+  combine(renderers);
+}
+
+void StaticBatchingUtility::sweepDestroyOnLoad()
+{
+  std::vector<shared<StaticBatch> >& batches = Application::context->staticBatches;
+
+  batches.erase(std::remove_if(batches.begin(), batches.end(),
+    isDestroyOnLoad), batches.end());
+}
+
+}
+
+}
+
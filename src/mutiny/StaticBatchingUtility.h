@@ -0,0 +1,62 @@
+#ifndef MUTINY_ENGINE_STATICBATCHINGUTILITY_H
+#define MUTINY_ENGINE_STATICBATCHINGUTILITY_H
+
+#include "ref.h"
+#include "Matrix4x4.h"
+
+#include <vector>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+class Application;
+class GameObject;
+class MeshRenderer;
+class Mesh;
+
+// A combined mesh together with the renderers it replaces. The model matrix
+// each renderer had when it was combined is kept so the batch can be rebuilt
+// once one of them moves.
+class StaticBatch
+{
+public:
+  shared<Mesh> mesh;
+  ref<GameObject> gameObject;
+  bool destroyOnLoad;
+  std::vector<ref<MeshRenderer> > renderers;
+  std::vector<Matrix4x4> matrices;
+
+};
+
+class StaticBatchingUtility
+{
+  friend class mutiny::engine::Application;
+
+public:
+  static void combine();
+  static void combine(ref<GameObject> root);
+
+private:
+  static const int MAX_BATCH_VERTICES = 65535;
+  static const float CHUNK_SIZE;
+
+  static void collect(ref<GameObject> gameObject,
+    std::vector<ref<MeshRenderer> >& renderers);
+
+  static void combine(std::vector<ref<MeshRenderer> >& renderers);
+  static void update();
+  static void sweepDestroyOnLoad();
+  static bool isStale(StaticBatch* batch);
+  static bool contains(StaticBatch* batch, MeshRenderer* renderer);
+
+};
+
+}
+
+}
+
+#endif
+
@@ -8,7 +8,7 @@ namespace engine
 
 Texture::Texture()
 {
-
+  uvRect = Rect(0, 0, 1, 1);
 }
 
 Texture::~Texture()
@@ -28,9 +28,16 @@ int Texture::getHeight()
 
 GLuint Texture::getNativeTexture()
 {
+  use();
+
   return nativeTexture->getGLuint();
 }
 
+void Texture::use()
+{
+
+}
+
 }
 
 }
@@ -3,9 +3,9 @@
 
 #include "ref.h"
 #include "Object.h"
+#include "Rect.h"
 #include "internal/glmm.h"
-
-#include <GL/glew.h>
+#include "internal/OpenGl.h"
 
 #include <memory>
 
@@ -15,8 +15,20 @@ namespace mutiny
 namespace engine
 {
 
+class Graphics;
+
+namespace internal
+{
+  class GuiDrawList;
+  class TextureAtlas;
+}
+
 class Texture : public Object
 {
+  friend class mutiny::engine::Graphics;
+  friend class mutiny::engine::internal::GuiDrawList;
+  friend class mutiny::engine::internal::TextureAtlas;
+
 public:
   Texture();
   virtual ~Texture();
@@ -30,8 +42,14 @@ protected:
   int height;
 
   shared<gl::Uint> nativeTexture;
+
+  // Region of nativeTexture holding the image when it lives in an atlas
+  Rect uvRect;
   //ref<gl::Uint> nativeTexture;
 
+  // Called before nativeTexture is handed out to bind
+  virtual void use();
+
 };
 
 }
@@ -4,8 +4,12 @@
 #include "Mathf.h"
 #include "Debug.h"
 #include "internal/CWrapper.h"
+#include "internal/TextureAtlas.h"
 #include "Exception.h"
+#include "Resources.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <functional>
 #include <vector>
@@ -28,6 +32,8 @@ shared<Texture2d> Texture2d::create(int width, int height)
 
 Texture2d::Texture2d()
 {
+  textureWidth = 0;
+  textureHeight = 0;
   width = 256;
   height = 256;
   //Application::context->paths.push_back("");
@@ -36,6 +42,8 @@ Texture2d::Texture2d()
 
 Texture2d::Texture2d(int width, int height)
 {
+  textureWidth = 0;
+  textureHeight = 0;
   this->width = width;
   this->height = height;
   //Application::context->paths.push_back("");
@@ -47,6 +55,31 @@ Texture2d::~Texture2d()
 
 }
 
+// Channels are clamped and rounded to bytes. Both conversions run over
+// plain float and byte arrays so that the compiler can vectorize them.
+static void encodeColors(const Color* colors, size_t count, unsigned char* output)
+{
+  const float* values = (const float*)colors;
+
+  for(size_t i = 0; i < count * 4; i++)
+  {
+    float value = values[i] * 255.0f + 0.5f;
+
+    value = value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value);
+    output[i] = (unsigned char)value;
+  }
+}
+
+static void decodeColors(const unsigned char* input, size_t count, Color* colors)
+{
+  float* values = (float*)colors;
+
+  for(size_t i = 0; i < count * 4; i++)
+  {
+    values[i] = input[i] * (1.0f / 255.0f);
+  }
+}
+
 void Texture2d::setPixel(int x, int y, Color color)
 {
   if(pixels.size() < 1)
@@ -54,93 +87,343 @@ void Texture2d::setPixel(int x, int y, Color color)
     populateSpace();
   }
 
-  if(y >= pixels.size() || x >= pixels.at(0).size())
+  if(x < 0 || y < 0 || x >= width || y >= height)
   {
     return;
   }
 
-  pixels.at(y).at(x) = color;
+  encodeColors(&color, 1, &pixels[(y * width + x) * 4]);
+  addDirtyRegion(x, y, 1, 1);
 }
 
 Color Texture2d::getPixel(int x, int y)
 {
-  return pixels.at(y).at(x);
+  Color rtn;
+
+  if(x < 0 || y < 0 || x >= width || y >= height)
+  {
+    throw Exception("Pixel out of bounds");
+  }
+
+  if(pixels.size() < 1)
+  {
+    populateSpace();
+  }
+
+  decodeColors(&pixels[(y * width + x) * 4], 1, &rtn);
+
+  return rtn;
+}
+
+void Texture2d::setPixels(const std::vector<Color>& colors)
+{
+  setPixels(0, 0, width, height, colors);
 }
 
-void Texture2d::resize(int width, int height)
+// The block is given row by row. Any part of it outside the texture is
+// ignored as it is by setPixel.
+void Texture2d::setPixels(int x, int y, int blockWidth, int blockHeight,
+  const std::vector<Color>& colors)
 {
-  this->width = width;
-  this->height = height;
+  if(blockWidth < 1 || blockHeight < 1)
+  {
+    return;
+  }
+
+  if(colors.size() < (size_t)blockWidth * blockHeight)
+  {
+    throw Exception("Not enough colors for the block");
+  }
+
+  if(pixels.size() < 1)
+  {
+    populateSpace();
+  }
+
+  int minX = std::max(x, 0);
+  int minY = std::max(y, 0);
+  int maxX = std::min(x + blockWidth, width);
+  int maxY = std::min(y + blockHeight, height);
+
+  if(minX >= maxX || minY >= maxY)
+  {
+    return;
+  }
+
+  for(int row = minY; row < maxY; row++)
+  {
+    encodeColors(&colors[(row - y) * blockWidth + (minX - x)], maxX - minX,
+      &pixels[(row * width + minX) * 4]);
+  }
+
+  addDirtyRegion(minX, minY, maxX - minX, maxY - minY);
+}
+
+// As setPixels but from tightly packed RGBA bytes
+void Texture2d::setPixels32(int x, int y, int blockWidth, int blockHeight,
+  const unsigned char* colors)
+{
+  if(blockWidth < 1 || blockHeight < 1)
+  {
+    return;
+  }
+
+  if(pixels.size() < 1)
+  {
+    populateSpace();
+  }
+
+  int minX = std::max(x, 0);
+  int minY = std::max(y, 0);
+  int maxX = std::min(x + blockWidth, width);
+  int maxY = std::min(y + blockHeight, height);
+
+  if(minX >= maxX || minY >= maxY)
+  {
+    return;
+  }
+
+  for(int row = minY; row < maxY; row++)
+  {
+    memcpy(&pixels[(row * width + minX) * 4],
+      colors + ((row - y) * blockWidth + (minX - x)) * 4, (maxX - minX) * 4);
+  }
+
+  addDirtyRegion(minX, minY, maxX - minX, maxY - minY);
+}
+
+std::vector<Color> Texture2d::getPixels()
+{
+  return getPixels(0, 0, width, height);
+}
+
+std::vector<Color> Texture2d::getPixels(int x, int y, int blockWidth, int blockHeight)
+{
+  std::vector<Color> rtn;
+
+  if(x < 0 || y < 0 || blockWidth < 0 || blockHeight < 0 ||
+    x + blockWidth > width || y + blockHeight > height)
+  {
+    throw Exception("Pixel block out of bounds");
+  }
+
+  if(pixels.size() < 1)
+  {
+    populateSpace();
+  }
+
+  rtn.resize(blockWidth * blockHeight);
+
+  for(int row = 0; row < blockHeight && blockWidth > 0; row++)
+  {
+    decodeColors(&pixels[((y + row) * width + x) * 4], blockWidth,
+      &rtn[row * blockWidth]);
+  }
+
+  return rtn;
+}
 
-  while(pixels.size() < height)
+// Contents are kept where the old and new sizes overlap and the rest is
+// cleared. The whole image is uploaded by the next apply.
+void Texture2d::resize(int width, int height)
+{
+  // Changes made before the resize would otherwise never be uploaded
+  if(width == this->width && height == this->height)
   {
-    pixels.push_back(std::vector<Color>(width));
+    return;
   }
 
-  for(int y = 0; y < height; y++)
+  if(pixels.size() > 0)
   {
-    while(pixels.at(y).size() < width)
+    std::vector<unsigned char> resized(width * height * 4);
+    int copyWidth = std::min(width, this->width);
+    int copyHeight = std::min(height, this->height);
+
+    for(int y = 0; y < copyHeight && copyWidth > 0; y++)
     {
-      pixels.at(y).push_back(Color(0, 0, 0, 0));
+      memcpy(&resized[y * width * 4], &pixels[y * this->width * 4], copyWidth * 4);
     }
+
+    pixels.swap(resized);
+  }
+
+  this->width = width;
+  this->height = height;
+  dirtyRegions.clear();
+
+  // Resizing back to the size of the native texture before an apply keeps
+  // it, so the whole image must be uploaded into it
+  if(pixels.size() > 0)
+  {
+    addDirtyRegion(0, 0, width, height);
   }
 }
 
 void Texture2d::populateSpace()
 {
-  for(int y = 0; y < height; y++)
+  pixels.assign(width * height * 4, 0);
+  addDirtyRegion(0, 0, width, height);
+}
+
+// Regions that touch are merged so a run of setPixel calls becomes one
+// region. Past a handful the bounds of them all are uploaded instead.
+void Texture2d::addDirtyRegion(int x, int y, int width, int height)
+{
+  Texture2dRegion region;
+  region.x = x;
+  region.y = y;
+  region.width = width;
+  region.height = height;
+
+  for(size_t i = 0; i < dirtyRegions.size(); i++)
   {
-    pixels.push_back(std::vector<Color>(width));
+    Texture2dRegion& other = dirtyRegions.at(i);
+
+    if(x >= other.x && y >= other.y && x + width <= other.x + other.width &&
+      y + height <= other.y + other.height)
+    {
+      return;
+    }
+  }
+
+  bool merged = true;
+
+  while(merged == true)
+  {
+    merged = false;
+
+    for(size_t i = 0; i < dirtyRegions.size(); i++)
+    {
+      Texture2dRegion& other = dirtyRegions.at(i);
+
+      if(region.x <= other.x + other.width && other.x <= region.x + region.width &&
+        region.y <= other.y + other.height && other.y <= region.y + region.height)
+      {
+        region = mergeRegions(region, other);
+        dirtyRegions.erase(dirtyRegions.begin() + i);
+        merged = true;
+        break;
+      }
+    }
+  }
+
+  dirtyRegions.push_back(region);
+
+  if(dirtyRegions.size() > MAX_DIRTY_REGIONS)
+  {
+    for(size_t i = 1; i < dirtyRegions.size(); i++)
+    {
+      dirtyRegions.at(0) = mergeRegions(dirtyRegions.at(0), dirtyRegions.at(i));
+    }
+
+    dirtyRegions.resize(1);
   }
 }
 
-void Texture2d::apply()
+Texture2dRegion Texture2d::mergeRegions(Texture2dRegion a, Texture2dRegion b)
 {
-  std::vector<GLbyte> imageBytes;
+  Texture2dRegion rtn;
 
-  if(nativeTexture.get() == NULL)
+  rtn.x = std::min(a.x, b.x);
+  rtn.y = std::min(a.y, b.y);
+  rtn.width = std::max(a.x + a.width, b.x + b.width) - rtn.x;
+  rtn.height = std::max(a.y + a.height, b.y + b.height) - rtn.y;
+
+  return rtn;
+}
+
+// The first apply, or one after a resize, uploads the whole image. After
+// that only the regions changed since the last apply are uploaded.
+void Texture2d::apply()
+{
+  // An atlas view gets a texture of its own rather than writing over the
+  // page it shares with other images
+  if(atlas.get() != NULL)
   {
-    nativeTexture = gl::Uint::genTexture();
+    atlas.reset();
+    nativeTexture.reset();
+    uvRect = Rect(0, 0, 1, 1);
   }
 
+  // The image no longer matches the file so must stay resident
+  path = "";
+
   if(pixels.size() < 1)
   {
     populateSpace();
   }
 
-  for(int y = 0; y < height; y++)
+  if(nativeTexture.get() == NULL || textureWidth != width || textureHeight != height)
   {
-    for(int x = 0; x < width; x++)
+    if(nativeTexture.get() == NULL)
     {
-      imageBytes.push_back(pixels[y][x].r * 255.0f);
-      imageBytes.push_back(pixels[y][x].g * 255.0f);
-      imageBytes.push_back(pixels[y][x].b * 255.0f);
-      imageBytes.push_back(pixels[y][x].a * 255.0f);
+      nativeTexture = gl::Uint::genTexture();
     }
-  }
 
-  glBindTexture(GL_TEXTURE_2D, nativeTexture->getGLuint());
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, &imageBytes[0]);
+    glBindTexture(GL_TEXTURE_2D, nativeTexture->getGLuint());
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+      pixels.size() > 0 ? &pixels[0] : NULL);
 
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 /*
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    if(glGenerateMipmap != NULL)
+    {
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+      glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    else
+    {
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    }
+*/
+
+    //glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    //glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D, 0);
 
-  if(glGenerateMipmap != NULL)
+    textureWidth = width;
+    textureHeight = height;
+    dirtyRegions.clear();
+
+    return;
+  }
+
+  if(dirtyRegions.size() < 1)
   {
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    return;
   }
-  else
+
+  glBindTexture(GL_TEXTURE_2D, nativeTexture->getGLuint());
+
+  for(size_t i = 0; i < dirtyRegions.size(); i++)
   {
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    Texture2dRegion& region = dirtyRegions.at(i);
+    unsigned char* data = &pixels[(region.y * width + region.x) * 4];
+
+    // GLES has no unpack row length so a region narrower than the image
+    // is copied out to rows of its own width first
+    if(region.width != width)
+    {
+      regionBytes.resize(region.width * region.height * 4);
+
+      for(int y = 0; y < region.height; y++)
+      {
+        memcpy(&regionBytes[y * region.width * 4],
+          &pixels[((region.y + y) * width + region.x) * 4], region.width * 4);
+      }
+
+      data = &regionBytes[0];
+    }
+
+    glTexSubImage2D(GL_TEXTURE_2D, 0, region.x, region.y, region.width, region.height,
+      GL_RGBA, GL_UNSIGNED_BYTE, data);
   }
-*/
 
-  //glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  //glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
   glBindTexture(GL_TEXTURE_2D, 0);
+  dirtyRegions.clear();
 }
 
 int poweroftwo(int input)
@@ -157,6 +440,13 @@ int poweroftwo(int input)
 }
 
 ref<Texture2d> Texture2d::load(std::string path)
+{
+  return load(path, NULL);
+}
+
+// Reads the PNG and resamples it to power of two dimensions. Nothing here
+// touches GL so it may run on a loader thread.
+shared<internal::PngData> Texture2d::decode(std::string path)
 {
   shared<internal::PngData> image = internal::PngData::create();
   path = path + ".png";
@@ -166,13 +456,6 @@ ref<Texture2d> Texture2d::load(std::string path)
     throw Exception("Failed to decode PNG file");
   }
 
-  ref<Texture2d> texture = new Texture2d(image->width, image->height);
-
-  if(texture->nativeTexture.get() == NULL)
-  {
-    texture->nativeTexture = gl::Uint::genTexture();
-  }
-
   int sampleWidth = image->width;
   int sampleHeight = image->height;
 
@@ -181,7 +464,9 @@ ref<Texture2d> Texture2d::load(std::string path)
 
   //std::cout << sampleWidth << " " << sampleHeight << std::endl;
 
-  std::vector<GLbyte> imageBytes(sampleHeight * sampleWidth * 4);
+  image->sampleWidth = sampleWidth;
+  image->sampleHeight = sampleHeight;
+  image->samples.resize(sampleHeight * sampleWidth * 4);
 
   double scaleWidth =  (double)sampleWidth / (double)image->width;
   double scaleHeight = (double)sampleHeight / (double)image->height;
@@ -192,15 +477,49 @@ ref<Texture2d> Texture2d::load(std::string path)
     {
       int pixel = (cy * (sampleWidth * 4)) + (cx * 4);
       int nearestMatch =  (((int)(cy / scaleHeight) * (image->width * 4)) + ((int)(cx / scaleWidth) * 4) );
-      imageBytes[pixel    ] =  image->image[nearestMatch    ];
-      imageBytes[pixel + 1] =  image->image[nearestMatch + 1];
-      imageBytes[pixel + 2] =  image->image[nearestMatch + 2];
-      imageBytes[pixel + 3] =  image->image[nearestMatch + 3];
+      image->samples[pixel    ] =  image->image[nearestMatch    ];
+      image->samples[pixel + 1] =  image->image[nearestMatch + 1];
+      image->samples[pixel + 2] =  image->image[nearestMatch + 2];
+      image->samples[pixel + 3] =  image->image[nearestMatch + 3];
     }
   }
 
-  glBindTexture(GL_TEXTURE_2D, texture->nativeTexture->getGLuint());
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, sampleWidth, sampleHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, &imageBytes[0]);
+  return image;
+}
+
+// The image is given when it was already decoded on a loader thread
+ref<Texture2d> Texture2d::load(std::string path, internal::PngData* image)
+{
+  ref<Texture2d> atlased = internal::TextureAtlas::find(path);
+  shared<internal::PngData> decoded;
+
+  if(atlased.valid())
+  {
+    return atlased;
+  }
+
+  if(image == NULL)
+  {
+    decoded = decode(path);
+    image = decoded.get();
+  }
+
+  ref<Texture2d> texture = new Texture2d(image->width, image->height);
+  texture->path = path;
+  texture->upload(image);
+
+  return texture;
+}
+
+void Texture2d::upload(internal::PngData* image)
+{
+  if(nativeTexture.get() == NULL)
+  {
+    nativeTexture = gl::Uint::genTexture();
+  }
+
+  glBindTexture(GL_TEXTURE_2D, nativeTexture->getGLuint());
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image->sampleWidth, image->sampleHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, &image->samples[0]);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
   //glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
@@ -209,7 +528,99 @@ ref<Texture2d> Texture2d::load(std::string path)
   //glGenerateMipmap(GL_TEXTURE_2D);
   glBindTexture(GL_TEXTURE_2D, 0);
 
-  return texture;
+  textureWidth = image->sampleWidth;
+  textureHeight = image->sampleHeight;
+}
+
+// Reads an evicted texture back from its file before it is bound
+void Texture2d::use()
+{
+  markUsed();
+
+  if(nativeTexture.get() != NULL || path == "")
+  {
+    return;
+  }
+
+  try
+  {
+    shared<internal::PngData> image = decode(path);
+    upload(image.get());
+  }
+  catch(std::exception& e)
+  {
+    Debug::logError("Failed to reload texture '" + path + "'");
+    path = "";
+    nativeTexture = Application::context->defaultTexture->nativeTexture;
+  }
+}
+
+size_t Texture2d::getResidentSize()
+{
+  size_t rtn = 0;
+
+  if(nativeTexture.get() != NULL)
+  {
+    rtn += textureWidth * textureHeight * 4;
+  }
+
+  rtn += pixels.size();
+
+  return rtn;
+}
+
+// An atlas view shares its page so there is nothing of its own to release
+bool Texture2d::canEvict()
+{
+  return path != "" && atlas.get() == NULL && nativeTexture.get() != NULL;
+}
+
+void Texture2d::evict()
+{
+  nativeTexture.reset();
+}
+
+template<> void ResourceRequest<Texture2d>::decode()
+{
+  for(size_t i = 0; i < paths.size(); i++)
+  {
+    try
+    {
+      data = Texture2d::decode(paths.at(i));
+      foundPath = paths.at(i);
+
+      return;
+    }
+    catch(std::exception& e) { }
+  }
+}
+
+template<> void ResourceRequest<Texture2d>::upload()
+{
+  asset = Resources::find<Texture2d>(path);
+
+  // Images packed into an atlas may have no file of their own to decode
+  // so anything not decoded goes through the usual search
+  if(asset.expired() == true && data.get() == NULL)
+  {
+    asset = Resources::load<Texture2d>(path);
+  }
+  else if(asset.expired() == true)
+  {
+    try
+    {
+      asset = Texture2d::load(foundPath, (internal::PngData*)data.get());
+
+      Resources::add(path, shared<Texture2d>(asset.get()));
+    }
+    catch(std::exception& e)
+    {
+      asset = NULL;
+    }
+  }
+
+  data.reset();
+  done = true;
 }
 
 }
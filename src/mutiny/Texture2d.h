@@ -2,8 +2,10 @@
 #define MUTINY_ENGINE_TEXTURE2D_H
 
 #include "Texture.h"
+#include "internal/ResourceCache.h"
 
 #include <vector>
+#include <string>
 
 namespace mutiny
 {
@@ -17,12 +19,32 @@ class Font;
 class Application;
 class MeshRenderer;
 
-class Texture2d : public Texture
+template<class T> class ResourceRequest;
+
+namespace internal
+{
+  class TextureAtlas;
+  struct PngData;
+}
+
+class Texture2dRegion
+{
+public:
+  int x;
+  int y;
+  int width;
+  int height;
+
+};
+
+class Texture2d : public Texture, public internal::EvictableResource
 {
   friend class Resources;
   friend class Font;
   friend class Application;
   friend class MeshRenderer;
+  friend class mutiny::engine::internal::TextureAtlas;
+  template<class T> friend class mutiny::engine::ResourceRequest;
 
 public:
   static shared<Texture2d> create(int width, int height);
@@ -32,14 +54,46 @@ public:
   void resize(int width, int height);
   void setPixel(int x, int y, Color color);
   Color getPixel(int x, int y);
+  void setPixels(const std::vector<Color>& colors);
+  void setPixels(int x, int y, int blockWidth, int blockHeight,
+    const std::vector<Color>& colors);
+  void setPixels32(int x, int y, int blockWidth, int blockHeight,
+    const unsigned char* colors);
+  std::vector<Color> getPixels();
+  std::vector<Color> getPixels(int x, int y, int blockWidth, int blockHeight);
   void apply();
 
 private:
   static ref<Texture2d> load(std::string path);
+  static ref<Texture2d> load(std::string path, internal::PngData* image);
+  static shared<internal::PngData> decode(std::string path);
+
+  static const size_t MAX_DIRTY_REGIONS = 8;
+
+  static Texture2dRegion mergeRegions(Texture2dRegion a, Texture2dRegion b);
 
-  std::vector<std::vector<Color> > pixels;
+  // RGBA bytes, row after row from the top, allocated on first use
+  std::vector<unsigned char> pixels;
+  std::vector<Texture2dRegion> dirtyRegions;
+  std::vector<unsigned char> regionBytes;
+  shared<Texture2d> atlas;
+
+  // File the texture was loaded from, kept while its image is unchanged so
+  // that an evicted texture can be read back
+  std::string path;
+
+  // Size of the image last given to glTexImage2D
+  int textureWidth;
+  int textureHeight;
 
   void populateSpace();
+  void addDirtyRegion(int x, int y, int width, int height);
+  void upload(internal::PngData* image);
+
+  virtual void use();
+  virtual size_t getResidentSize();
+  virtual bool canEvict();
+  virtual void evict();
 
 };
 
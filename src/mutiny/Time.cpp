@@ -7,6 +7,7 @@ namespace engine
 {
 
 float Time::deltaTime = 0;
+float Time::fixedDeltaTime = 1.0f / 60.0f;
 
 float Time::getDeltaTime()
 {
@@ -18,6 +19,16 @@ float Time::getDeltaTime()
   return deltaTime;
 }
 
+float Time::getFixedDeltaTime()
+{
+  return fixedDeltaTime;
+}
+
+void Time::setFixedDeltaTime(float fixedDeltaTime)
+{
+  Time::fixedDeltaTime = fixedDeltaTime;
+}
+
 }
 
 }
@@ -14,9 +14,12 @@ class Time
 
 public:
   static float getDeltaTime();
+  static float getFixedDeltaTime();
+  static void setFixedDeltaTime(float fixedDeltaTime);
 
 private:
   static float deltaTime;
+  static float fixedDeltaTime;
 
 };
 
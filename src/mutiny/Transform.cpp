@@ -19,71 +19,124 @@ void Transform::onAwake()
 {
   //Debug::log("Transform awake");
   parent = NULL;
-  localScale = Vector3(1, 1, 1);
+  index = getStore()->add(this);
 }
 
 void Transform::onDestroy()
 {
+  if(index == -1)
+  {
+    return;
+  }
+
   detachChildren();
   setParent(NULL);
 }
 
+// Called by the GameObject once all of its components are destroyed so
+// that any of them can still read the transform from onDestroy
+void Transform::release()
+{
+  if(index == -1)
+  {
+    return;
+  }
+
+  getStore()->remove(index);
+  index = -1;
+}
+
+internal::TransformStore* Transform::getStore()
+{
+  return Application::context->transformStore.get();
+}
+
+void Transform::setDirty()
+{
+  internal::TransformStore* store = getStore();
+
+  // A dirty transform always has dirty descendants so there is no need to
+  // walk any further.
+  if(store->dirty.at(index) == true)
+  {
+    return;
+  }
+
+  store->dirty.at(index) = true;
+  store->inverseDirty.at(index) = true;
+
+  for(size_t i = 0; i < children.size(); i++)
+  {
+    children.at(i)->setDirty();
+  }
+}
+
+Matrix4x4 Transform::getLocalToWorldMatrix()
+{
+  getStore()->update(index);
+
+  return getStore()->localToWorldMatrices.at(index);
+}
+
+Matrix4x4 Transform::getWorldToLocalMatrix()
+{
+  getStore()->updateInverse(index);
+
+  return getStore()->worldToLocalMatrices.at(index);
+}
+
 void Transform::setLocalRotation(Vector3 rotation)
 {
-  localRotation = rotation;
+  getStore()->localRotations.at(index) = rotation;
+  setDirty();
 }
 
 void Transform::setLocalPosition(Vector3 position)
 {
   // Take off parent's existing position. Use setLocalPosition to set directly.
-  localPosition = position;
+  getStore()->localPositions.at(index) = position;
+  setDirty();
 }
 
 void Transform::setLocalScale(Vector3 scale)
 {
-  localScale = scale;
+  getStore()->localScales.at(index) = scale;
 }
 
 Vector3 Transform::getLocalPosition()
 {
-  return localPosition;
+  return getStore()->localPositions.at(index);
 }
 
 Vector3 Transform::getLocalRotation()
 {
-  return localRotation;
+  return getStore()->localRotations.at(index);
 }
 
 void Transform::setRotation(Vector3 rotation)
 {
   if(getParent().valid())
   {
-    localRotation = rotation - getParent()->getRotation();
+    setLocalRotation(rotation - getParent()->getRotation());
   }
   else
   {
-    localRotation = rotation;
+    setLocalRotation(rotation);
   }
 }
 
 void Transform::setPosition(Vector3 position)
 {
-  if(getParent().valid())
-  {
-    Matrix4x4 trs = Matrix4x4::getIdentity();
-    ref<Transform> trans = getParent();
-
-    while(trans.valid())
-    {
-      trs = Matrix4x4::getTrs(trans->localPosition, trans->localRotation, Vector3(1, 1, 1)) * trs;
-      trans = trans->getParent();
-    }
+  internal::TransformStore* store = getStore();
 
-    localPosition = trs.inverse() * position;
+  if(parent.valid())
+  {
+    store->update(parent->index);
+    setLocalPosition(store->hierarchyMatrices.at(parent->index).inverse() * position);
   }
   else
   {
-    localPosition = position;
+    setLocalPosition(position);
   }
 }
 
@@ -96,49 +149,37 @@ void Transform::setScale(Vector3 scale)
 
     while(trans.valid())
     {
-      trs = Matrix4x4::getTrs(trans->localPosition, trans->localRotation, trans->localScale) * trs;
+      trs = Matrix4x4::getTrs(trans->getLocalPosition(), trans->getLocalRotation(),
+        trans->getScale()) * trs;
+
       trans = trans->getParent();
     }
 
-    localScale = trs.inverse() * scale;
+    setLocalScale(trs.inverse() * scale);
   }
   else
   {
-    localScale = scale;
+    setLocalScale(scale);
   }
 }
 
 Vector3 Transform::getPosition()
 {
-  Matrix4x4 trs = Matrix4x4::getIdentity();
-  ref<Transform> trans = this;
+  getStore()->update(index);
 
-  while(trans.valid())
-  {
-    trs = Matrix4x4::getTrs(trans->localPosition, trans->localRotation, Vector3(1, 1, 1)) * trs;
-    trans = trans->getParent();
-  }
-
-  return trs * Vector3();
+  return getStore()->positions.at(index);
 }
 
 Vector3 Transform::getRotation()
 {
-  ref<Transform> trans = this;
-  Vector3 rotation;
+  getStore()->update(index);
 
-  while(trans.valid())
-  {
-    rotation = rotation + trans->localRotation;
-    trans = trans->getParent();
-  }
-
-  return rotation;
+  return getStore()->rotations.at(index);
 }
 
 Vector3 Transform::getScale()
 {
-  return localScale;
+  return getStore()->localScales.at(index);
 }
 
 void Transform::detachChildren()
@@ -201,6 +242,8 @@ void Transform::setParent(ref<Transform> transform)
   setLocalPosition(getPosition());
   setLocalRotation(getRotation());
   this->parent = transform;
+  getStore()->setParent(index, transform.valid() ? transform->index : -1);
+  setDirty();
   setPosition(getLocalPosition());
   setRotation(getLocalRotation());
 }
@@ -231,20 +274,29 @@ ref<Transform> Transform::getRoot()
 
 void Transform::rotate(Vector3 eulerAngles)
 {
+  Vector3& localRotation = getStore()->localRotations.at(index);
+
   localRotation.x += eulerAngles.x;
   localRotation.y += eulerAngles.y;
   localRotation.z += eulerAngles.z;
+  setDirty();
 }
 
 void Transform::translate(Vector3 translation)
 {
+  Vector3& localPosition = getStore()->localPositions.at(index);
+
   localPosition.x += translation.x;
   localPosition.y += translation.y;
   localPosition.z += translation.z;
+  setDirty();
 }
 
 void Transform::lookAt(Vector3 worldPosition)
 {
+  Vector3& localPosition = getStore()->localPositions.at(index);
+  Vector3& localRotation = getStore()->localRotations.at(index);
+
   //Vector3 diff = Vector3(localPosition.x, localPosition.y, localPosition.z) - Vector3(worldPosition.x, worldPosition.y, worldPosition.z);
 
   //float angle = atan2(diff.y, sqrt(diff.x * diff.x + diff.z * diff.z)) * 180.0f / 3.14159265359f;
@@ -261,10 +313,13 @@ void Transform::lookAt(Vector3 worldPosition)
 
   float angle = atan2(diff2.x, diff2.y) * 180 / 3.14159265359f;
   localRotation.y = angle - 180.0f;
+  setDirty();
 }
 
 void Transform::rotateAround(Vector3 center, Vector3 axis, float amount)
 {
+  Vector3& localPosition = getStore()->localPositions.at(index);
+
   Matrix4x4 pos = Matrix4x4::getTrs(center,
                                     Vector3(0, 0, 0), Vector3(1, 1, 1));
 
@@ -277,18 +332,19 @@ void Transform::rotateAround(Vector3 center, Vector3 axis, float amount)
   curr = curr * pos.inverse();
 
   localPosition = curr * localPosition;
+  setDirty();
 }
 
 Vector3 Transform::getForward()
 {
-  Matrix4x4 m = Matrix4x4::getTrs(localPosition, localRotation, Vector3(1, 1, 1));
+  Matrix4x4 m = Matrix4x4::getTrs(getLocalPosition(), getLocalRotation(), Vector3(1, 1, 1));
 
   return m.multiplyVector(Vector3(0, 0, 1));  
 }
 
 Vector3 Transform::getRight()
 {
-  Matrix4x4 m = Matrix4x4::getTrs(localPosition, localRotation, Vector3(1, 1, 1));
+  Matrix4x4 m = Matrix4x4::getTrs(getLocalPosition(), getLocalRotation(), Vector3(1, 1, 1));
 
   return m.multiplyVector(Vector3(1, 0, 0));  
 }
@@ -3,6 +3,8 @@
 
 #include "Behaviour.h"
 #include "Vector3.h"
+#include "Matrix4x4.h"
+#include "internal/TransformStore.h"
 
 #include <vector>
 
@@ -14,6 +16,9 @@ namespace engine
 
 class Transform : public Behaviour
 {
+  friend class mutiny::engine::internal::TransformStore;
+  friend class mutiny::engine::GameObject;
+
 public:
   virtual ~Transform();
 
@@ -46,13 +51,18 @@ public:
   Vector3 getForward();
   Vector3 getRight();
 
+  Matrix4x4 getLocalToWorldMatrix();
+  Matrix4x4 getWorldToLocalMatrix();
+
 private:
-  Vector3 localPosition;
-  Vector3 localRotation;
-  Vector3 localScale;
+  int index;
   ref<Transform> parent;
   std::vector<ref<Transform> > children;
 
+  internal::TransformStore* getStore();
+  void setDirty();
+  void release();
+
   virtual void onAwake();
   virtual void onDestroy();
 
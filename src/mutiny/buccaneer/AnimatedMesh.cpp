@@ -3,7 +3,7 @@
 #include "../Resources.h"
 #include "../Texture2d.h"
 
-#include "../internal/WavefrontParser.h"
+#include "../internal/MeshFile.h"
 
 namespace mutiny
 {
@@ -13,32 +13,41 @@ namespace engine
 
 ref<AnimatedMesh> AnimatedMesh::load(std::string path)
 {
-  internal::WavefrontParser parser(path + ".obj");
-  ref<internal::ModelData> modelData = parser.getModelData();
-  std::vector<Vector3> vertices;
-  std::vector<Vector3> normals;
-  std::vector<Vector2> uv;
-  std::vector<std::vector<int> > triangles;
-  int currentSubmesh = 0;
+  shared<internal::MeshFile> file = internal::MeshFile::load(path);
+  internal::MeshFileHeader* header = file->header;
   ref<AnimatedMesh> animatedMesh = new AnimatedMesh();
-  Vector3 boundsMax;
-  Vector3 boundsMin;
-  bool boundsSet = false;
 
-  for(int p = 0; p < modelData->parts.size(); p++)
+  for(size_t p = 0; p < header->partCount; p++)
   {
-    ref<internal::PartData> part = modelData->parts.at(p);
+    internal::MeshFilePart& part = file->parts[p];
     animatedMesh->textures.push_back(std::vector<ref<Texture2d> >());
-    animatedMesh->meshNames.push_back(part->name);
-    Vector3 max;
-    Vector3 min;
-    bool mmSet = false;
+    animatedMesh->meshNames.push_back(file->getString(part.name));
 
-    for(int m = 0; m < part->materialGroups.size(); m++)
+    Vector3 max(part.boundsMax[0], part.boundsMax[1], part.boundsMax[2]);
+    Vector3 min(part.boundsMin[0], part.boundsMin[1], part.boundsMin[2]);
+    Vector3 offset = (max + min) / 2.0f;
+    animatedMesh->meshOffsets.push_back(offset);
+
+    shared<Mesh> mesh(new Mesh());
+    animatedMesh->meshes.push_back(mesh);
+    mesh->vertices.resize(part.vertexCount);
+    mesh->normals.resize(part.vertexCount);
+    mesh->uv.resize(part.vertexCount);
+
+    // Each part is drawn about its own center
+    for(size_t i = 0; i < part.vertexCount; i++)
     {
-      ref<internal::MaterialGroupData> materialGroup = part->materialGroups.at(m);
-      //Debug::log(materialGroup->material->texture);
-      std::string texName = materialGroup->material->texture;
+      internal::MeshFileVertex& vertex = file->vertices[part.firstVertex + i];
+
+      mesh->vertices[i] = Vector3(vertex.position[0], vertex.position[1], vertex.position[2]) - offset;
+      mesh->normals[i] = Vector3(vertex.normal[0], vertex.normal[1], vertex.normal[2]);
+      mesh->uv[i] = Vector2(vertex.uv[0], vertex.uv[1]);
+    }
+
+    for(size_t s = 0; s < part.submeshCount; s++)
+    {
+      internal::MeshFileSubmesh& submesh = file->submeshes[part.firstSubmesh + s];
+      std::string texName = file->getTexture(submesh.material);
       texName = texName.substr(0, texName.length() - 4);
 
       ref<Texture2d> tex = Resources::load<Texture2d>(texName);
@@ -46,102 +55,26 @@ ref<AnimatedMesh> AnimatedMesh::load(std::string path)
       if(tex.expired())
       {
         Debug::logWarning("Failed to load texture '" + texName + "'");
-        //throw std::exception();
       }
 
-      animatedMesh->textures.at(animatedMesh->textures.size() - 1).push_back(tex);
+      animatedMesh->textures.at(p).push_back(tex);
 
-      triangles.push_back(std::vector<int>());
+      std::vector<int> triangles(submesh.indexCount);
 
-      for(int f = 0; f < materialGroup->faces.size(); f++)
+      for(size_t i = 0; i < submesh.indexCount; i++)
       {
-        ref<internal::FaceData> face = materialGroup->faces.at(f);
-
-        if(mmSet == false) { max.x = face->a.position.x; max.y = face->a.position.y; max.z = face->a.position.z;
-                             min.x = face->a.position.x; min.y = face->a.position.y; min.z = face->a.position.z;
-                             mmSet = true; }
-
-        if(face->a.position.x > max.x) { max.x = face->a.position.x; }
-        if(face->a.position.y > max.y) { max.y = face->a.position.y; }
-        if(face->a.position.z > max.z) { max.z = face->a.position.z; }
-
-        if(face->a.position.x < min.x) { min.x = face->a.position.x; }
-        if(face->a.position.y < min.y) { min.y = face->a.position.y; }
-        if(face->a.position.z < min.z) { min.z = face->a.position.z; }
-
-        if(face->b.position.x > max.x) { max.x = face->b.position.x; }
-        if(face->b.position.y > max.y) { max.y = face->b.position.y; }
-        if(face->b.position.z > max.z) { max.z = face->b.position.z; }
-
-        if(face->b.position.x < min.x) { min.x = face->b.position.x; }
-        if(face->b.position.y < min.y) { min.y = face->b.position.y; }
-        if(face->b.position.z < min.z) { min.z = face->b.position.z; }
-
-        if(face->c.position.x > max.x) { max.x = face->c.position.x; }
-        if(face->c.position.y > max.y) { max.y = face->c.position.y; }
-        if(face->c.position.z > max.z) { max.z = face->c.position.z; }
-
-        if(face->c.position.x < min.x) { min.x = face->c.position.x; }
-        if(face->c.position.y < min.y) { min.y = face->c.position.y; }
-        if(face->c.position.z < min.z) { min.z = face->c.position.z; }
-
-        triangles.at(currentSubmesh).push_back(vertices.size());
-        vertices.push_back(Vector3(face->a.position.x, face->a.position.y, face->a.position.z));
-        triangles.at(currentSubmesh).push_back(vertices.size());
-        vertices.push_back(Vector3(face->b.position.x, face->b.position.y, face->b.position.z));
-        triangles.at(currentSubmesh).push_back(vertices.size());
-        vertices.push_back(Vector3(face->c.position.x, face->c.position.y, face->c.position.z));
-
-        normals.push_back(Vector3(face->a.normal.x, face->a.normal.y, face->a.normal.z));
-        normals.push_back(Vector3(face->b.normal.x, face->b.normal.y, face->b.normal.z));
-        normals.push_back(Vector3(face->c.normal.x, face->c.normal.y, face->c.normal.z));
-
-        uv.push_back(Vector2(face->a.coord.x, face->a.coord.y));
-        uv.push_back(Vector2(face->b.coord.x, face->b.coord.y));
-        uv.push_back(Vector2(face->c.coord.x, face->c.coord.y));
+        triangles[i] = file->indices[submesh.firstIndex + i] - part.firstVertex;
       }
 
-      currentSubmesh++;
+      mesh->triangles.push_back(triangles);
     }
-    if(boundsSet == false) { boundsMax = max; boundsMin = min; boundsSet = true; }
-
-    if(max.x > boundsMax.x) boundsMax.x = max.x;
-    if(max.y > boundsMax.y) boundsMax.y = max.y;
-    if(max.z > boundsMax.z) boundsMax.z = max.z;
-
-    if(min.x < boundsMin.x) boundsMin.x = min.x;
-    if(min.y < boundsMin.y) boundsMin.y = min.y;
-    if(min.z < boundsMin.z) boundsMin.z = min.z;
-
-    Vector3 offset = (max + min) / 2.0f;
-    animatedMesh->meshOffsets.push_back(offset);
-
-    for(int i = 0; i < vertices.size(); i++)
-    {
-      vertices[i] = vertices[i] - offset;
-    }
-
-    shared<Mesh> mesh(new Mesh());
-    animatedMesh->meshes.push_back(mesh);
-    mesh->setVertices(vertices);
-    mesh->setNormals(normals);
-    mesh->setUv(uv);
-
-    for(int i = 0; i < triangles.size(); i++)
-    {
-      mesh->setTriangles(triangles.at(i), i);
-    }
-
-    vertices.clear();
-    uv.clear();
-    normals.clear();
-    triangles.clear();
-    currentSubmesh = 0;
 
-    //Debug::log("Loaded part");
+    mesh->bounds.setMinMax(min - offset, max - offset);
   }
 
-  animatedMesh->bounds.setMinMax(boundsMin, boundsMax);
+  animatedMesh->bounds.setMinMax(
+    Vector3(header->boundsMin[0], header->boundsMin[1], header->boundsMin[2]),
+    Vector3(header->boundsMax[0], header->boundsMax[1], header->boundsMax[2]));
 
   return animatedMesh;
 }
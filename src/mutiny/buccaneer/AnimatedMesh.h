@@ -6,8 +6,7 @@
 #include "../Bounds.h"
 #include "../Vector3.h"
 #include "../ref.h"
-
-#include <GL/glew.h>
+#include "../internal/OpenGl.h"
 
 #include <vector>
 #include <string>
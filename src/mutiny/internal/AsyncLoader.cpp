@@ -0,0 +1,158 @@
+#include "AsyncLoader.h"
+#include "CWrapper.h"
+#include "../Profiler.h"
+
+#include <algorithm>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+AsyncJob::~AsyncJob()
+{
+
+}
+
+shared<AsyncLoader> AsyncLoader::create()
+{
+  shared<AsyncLoader> rtn;
+
+  rtn.reset(new AsyncLoader());
+
+  return rtn;
+}
+
+AsyncLoader::AsyncLoader()
+{
+  mutex = Mutex::create();
+  activeWorkers = 0;
+
+  // One core is left to the main thread where there is one to spare
+  maxWorkers = std::max(1, std::min(Thread::getProcessorCount() - 1, (int)MAX_WORKERS));
+}
+
+AsyncLoader::~AsyncLoader()
+{
+  // Jobs not yet started are dropped and the workers joined while the
+  // mutex they share is still alive
+  mutex->lock();
+  pending.clear();
+  mutex->unlock();
+
+  workers.clear();
+}
+
+void AsyncLoader::add(shared<AsyncJob> job)
+{
+  shared<AsyncWorker> worker;
+
+  mutex->lock();
+  pending.push_back(job);
+
+  if(activeWorkers < maxWorkers)
+  {
+    activeWorkers++;
+    worker.reset(new AsyncWorker());
+    worker->loader = this;
+    worker->finished = false;
+    workers.push_back(worker);
+  }
+
+  mutex->unlock();
+
+  // Without threads this decodes the queue before returning
+  if(worker.get() != NULL)
+  {
+    worker->thread = Thread::create(workerMain, worker.get());
+  }
+}
+
+void AsyncLoader::workerMain(void* data)
+{
+  AsyncWorker* worker = (AsyncWorker*)data;
+  AsyncLoader* loader = worker->loader;
+
+  while(true)
+  {
+    loader->mutex->lock();
+
+    if(loader->pending.size() < 1)
+    {
+      loader->activeWorkers--;
+      worker->finished = true;
+      loader->mutex->unlock();
+
+      return;
+    }
+
+    shared<AsyncJob> job = loader->pending.front();
+    loader->pending.pop_front();
+    loader->mutex->unlock();
+
+    // A job that fails to decode is still handed back so its upload can
+    // report the failure on the main thread
+    try
+    {
+      job->decode();
+    }
+    catch(...) { }
+
+    loader->mutex->lock();
+    loader->decoded.push_back(job);
+    loader->mutex->unlock();
+  }
+}
+
+void AsyncLoader::update()
+{
+  double start = Profiler::getTime();
+
+  while(true)
+  {
+    shared<AsyncJob> job;
+
+    mutex->lock();
+
+    for(size_t i = 0; i < workers.size(); i++)
+    {
+      // Already returned so the join in the destructor does not wait
+      if(workers.at(i)->finished == true)
+      {
+        workers.erase(workers.begin() + i);
+        i--;
+      }
+    }
+
+    if(decoded.size() > 0)
+    {
+      job = decoded.front();
+      decoded.pop_front();
+    }
+
+    mutex->unlock();
+
+    if(job.get() == NULL)
+    {
+      break;
+    }
+
+    job->upload();
+
+    if(Profiler::getTime() - start >= UPLOAD_BUDGET)
+    {
+      break;
+    }
+  }
+}
+
+}
+
+}
+
+}
+
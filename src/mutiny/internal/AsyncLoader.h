@@ -0,0 +1,82 @@
+#ifndef MUTINY_ENGINE_INTERNAL_ASYNCLOADER_H
+#define MUTINY_ENGINE_INTERNAL_ASYNCLOADER_H
+
+#include "../ref.h"
+
+#include <vector>
+#include <deque>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+struct Thread;
+struct Mutex;
+class AsyncLoader;
+
+// Work for the loader in two halves. Decode runs on a loader thread and
+// must not touch GL or the Application context, upload runs later on the
+// main thread.
+class AsyncJob
+{
+public:
+  virtual ~AsyncJob();
+
+  virtual void decode() = 0;
+  virtual void upload() = 0;
+
+};
+
+class AsyncWorker
+{
+public:
+  AsyncLoader* loader;
+  shared<Thread> thread;
+  bool finished;
+
+};
+
+// Decodes queued jobs on a small set of threads which exit once the queue
+// is empty. Decoded jobs are uploaded from update on the main thread, as
+// many as fit in UPLOAD_BUDGET milliseconds each frame so that a burst of
+// loads is spread over frames rather than stalling one of them.
+class AsyncLoader
+{
+public:
+  static shared<AsyncLoader> create();
+
+  ~AsyncLoader();
+
+  void add(shared<AsyncJob> job);
+  void update();
+
+private:
+  static const int MAX_WORKERS = 4;
+  static const int UPLOAD_BUDGET = 4;
+
+  static void workerMain(void* data);
+
+  shared<Mutex> mutex;
+  std::deque<shared<AsyncJob> > pending;
+  std::deque<shared<AsyncJob> > decoded;
+  std::vector<shared<AsyncWorker> > workers;
+  size_t activeWorkers;
+  size_t maxWorkers;
+
+  AsyncLoader();
+
+};
+
+}
+
+}
+
+}
+
+#endif
+
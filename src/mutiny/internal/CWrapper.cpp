@@ -2,6 +2,14 @@
 #include "../Exception.h"
 #include "../Application.h"
 
+#ifndef _WIN32
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <dirent.h>
+#endif
+
 #include <cstdlib>
 
 namespace mutiny
@@ -19,6 +27,8 @@ shared<PngData> PngData::create()
   rtn->image = NULL;
   rtn->width = 0;
   rtn->height = 0;
+  rtn->sampleWidth = 0;
+  rtn->sampleHeight = 0;
 
   return rtn;
 }
@@ -28,6 +38,285 @@ PngData::~PngData()
   free(image);
 }
 
+shared<MappedFile> MappedFile::open(std::string path)
+{
+  shared<MappedFile> rtn(new MappedFile());
+  rtn->data = NULL;
+  rtn->size = 0;
+
+#ifdef _WIN32
+  rtn->mapping = NULL;
+  rtn->file = CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+  if(rtn->file == INVALID_HANDLE_VALUE)
+  {
+    throw Exception("Failed to open '" + path + "'");
+  }
+
+  rtn->size = GetFileSize(rtn->file, NULL);
+
+  if(rtn->size < 1)
+  {
+    throw Exception("Empty file '" + path + "'");
+  }
+
+  rtn->mapping = CreateFileMapping(rtn->file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+  if(rtn->mapping == NULL)
+  {
+    throw Exception("Failed to map '" + path + "'");
+  }
+
+  rtn->data = MapViewOfFile(rtn->mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+  int fd = ::open(path.c_str(), O_RDONLY);
+
+  if(fd == -1)
+  {
+    throw Exception("Failed to open '" + path + "'");
+  }
+
+  struct stat info;
+
+  if(fstat(fd, &info) == -1 || info.st_size < 1)
+  {
+    close(fd);
+    throw Exception("Empty file '" + path + "'");
+  }
+
+  rtn->size = info.st_size;
+  rtn->data = mmap(NULL, rtn->size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  // The mapping keeps its own reference to the file
+  close(fd);
+
+  if(rtn->data == MAP_FAILED)
+  {
+    rtn->data = NULL;
+  }
+#endif
+
+  if(rtn->data == NULL)
+  {
+    throw Exception("Failed to map '" + path + "'");
+  }
+
+  return rtn;
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+  if(data != NULL)
+  {
+    UnmapViewOfFile(data);
+  }
+
+  if(mapping != NULL)
+  {
+    CloseHandle(mapping);
+  }
+
+  if(file != INVALID_HANDLE_VALUE)
+  {
+    CloseHandle(file);
+  }
+#else
+  if(data != NULL)
+  {
+    munmap(data, size);
+  }
+#endif
+}
+
+#ifdef _WIN32
+static DWORD WINAPI threadMain(LPVOID data)
+#else
+static void* threadMain(void* data)
+#endif
+{
+  Thread* thread = (Thread*)data;
+
+  thread->func(thread->data);
+
+  return 0;
+}
+
+shared<Thread> Thread::create(void (*func)(void*), void* data)
+{
+  shared<Thread> rtn(new Thread());
+  rtn->func = func;
+  rtn->data = data;
+
+#if defined(_WIN32)
+  rtn->handle = CreateThread(NULL, 0, threadMain, rtn.get(), 0, NULL);
+  rtn->running = rtn->handle != NULL;
+#elif defined(EMSCRIPTEN)
+  rtn->running = false;
+#else
+  rtn->running = pthread_create(&rtn->thread, NULL, threadMain, rtn.get()) == 0;
+#endif
+
+  // Failing to start a thread only loses the concurrency
+  if(rtn->running == false)
+  {
+    func(data);
+  }
+
+  return rtn;
+}
+
+int Thread::getProcessorCount()
+{
+#if defined(_WIN32)
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+
+  return info.dwNumberOfProcessors;
+#elif defined(EMSCRIPTEN)
+  return 1;
+#else
+  long rtn = sysconf(_SC_NPROCESSORS_ONLN);
+
+  if(rtn < 1)
+  {
+    return 1;
+  }
+
+  return rtn;
+#endif
+}
+
+Thread::~Thread()
+{
+  if(running == false)
+  {
+    return;
+  }
+
+#ifdef _WIN32
+  WaitForSingleObject(handle, INFINITE);
+  CloseHandle(handle);
+#else
+  pthread_join(thread, NULL);
+#endif
+}
+
+shared<Mutex> Mutex::create()
+{
+  shared<Mutex> rtn(new Mutex());
+
+#ifdef _WIN32
+  InitializeCriticalSection(&rtn->section);
+#else
+  pthread_mutex_init(&rtn->mutex, NULL);
+#endif
+
+  return rtn;
+}
+
+Mutex::~Mutex()
+{
+#ifdef _WIN32
+  DeleteCriticalSection(&section);
+#else
+  pthread_mutex_destroy(&mutex);
+#endif
+}
+
+void Mutex::lock()
+{
+#ifdef _WIN32
+  EnterCriticalSection(&section);
+#else
+  pthread_mutex_lock(&mutex);
+#endif
+}
+
+void Mutex::unlock()
+{
+#ifdef _WIN32
+  LeaveCriticalSection(&section);
+#else
+  pthread_mutex_unlock(&mutex);
+#endif
+}
+
+// Names of the entries directly inside path, without "." and ".."
+bool Directory::list(std::string path, std::vector<std::string>& files,
+  std::vector<std::string>& directories)
+{
+#ifdef _WIN32
+  WIN32_FIND_DATA ffd;
+  HANDLE find = ::FindFirstFile((path + "\\*").c_str(), &ffd);
+
+  if(find == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+
+  do
+  {
+    std::string name = ffd.cFileName;
+
+    if(name == "." || name == "..")
+    {
+      continue;
+    }
+
+    if((ffd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+    {
+      directories.push_back(name);
+    }
+    else
+    {
+      files.push_back(name);
+    }
+  }
+  while(::FindNextFile(find, &ffd) != 0);
+
+  FindClose(find);
+#else
+  DIR* dir = opendir(path.c_str());
+
+  if(dir == NULL)
+  {
+    return false;
+  }
+
+  for(dirent* entry = readdir(dir); entry != NULL; entry = readdir(dir))
+  {
+    std::string name = entry->d_name;
+    struct stat info;
+
+    if(name == "." || name == "..")
+    {
+      continue;
+    }
+
+    // Symlinks are followed so linked data directories are indexed too
+    if(stat((path + "/" + name).c_str(), &info) != 0)
+    {
+      continue;
+    }
+
+    if(S_ISDIR(info.st_mode))
+    {
+      directories.push_back(name);
+    }
+    else
+    {
+      files.push_back(name);
+    }
+  }
+
+  closedir(dir);
+#endif
+
+  return true;
+}
+
 #ifdef _WIN32
 Win32FindData* Win32FindData::create()
 {
@@ -3,14 +3,17 @@
 
 #include "lodepng.h"
 #include "../ref.h"
-
-#include <GL/glew.h>
+#include "OpenGl.h"
 
 #ifdef _WIN32
   #include <windows.h>
+#else
+  #include <pthread.h>
 #endif
 
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace mutiny
 {
@@ -30,6 +33,64 @@ struct PngData
   unsigned char* image;
   unsigned width;
   unsigned height;
+
+  std::vector<unsigned char> samples;
+  unsigned sampleWidth;
+  unsigned sampleHeight;
+};
+
+struct MappedFile
+{
+  static shared<MappedFile> open(std::string path);
+  ~MappedFile();
+
+  void* data;
+  size_t size;
+
+#ifdef _WIN32
+  HANDLE file;
+  HANDLE mapping;
+#endif
+};
+
+// Runs a function on a thread of its own which is joined on destruction.
+// Where threads are unavailable the function has already run by the time
+// create returns.
+struct Thread
+{
+  static shared<Thread> create(void (*func)(void*), void* data);
+  static int getProcessorCount();
+  ~Thread();
+
+  void (*func)(void*);
+  void* data;
+  bool running;
+
+#ifdef _WIN32
+  HANDLE handle;
+#else
+  pthread_t thread;
+#endif
+};
+
+struct Mutex
+{
+  static shared<Mutex> create();
+  ~Mutex();
+  void lock();
+  void unlock();
+
+#ifdef _WIN32
+  CRITICAL_SECTION section;
+#else
+  pthread_mutex_t mutex;
+#endif
+};
+
+struct Directory
+{
+  static bool list(std::string path, std::vector<std::string>& files,
+    std::vector<std::string>& directories);
 };
 
 #ifdef _WIN32
@@ -0,0 +1,82 @@
+#include "Frustum.h"
+
+#include <cmath>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+Frustum::Frustum()
+{
+  // Until extracted every plane accepts everything
+  for(int i = 0; i < 6; i++)
+  {
+    planes[i][0] = 0;
+    planes[i][1] = 0;
+    planes[i][2] = 0;
+    planes[i][3] = 1;
+  }
+}
+
+void Frustum::extract(Matrix4x4 matrix)
+{
+  // Matrices are column major so row r of the matrix is m[c * 4 + r]
+  float* m = matrix.getValue();
+
+  for(int i = 0; i < 3; i++)
+  {
+    for(int c = 0; c < 4; c++)
+    {
+      planes[i * 2][c] = m[c * 4 + 3] + m[c * 4 + i];
+      planes[i * 2 + 1][c] = m[c * 4 + 3] - m[c * 4 + i];
+    }
+  }
+}
+
+bool Frustum::testAabb(Bounds& bounds)
+{
+  for(int i = 0; i < 6; i++)
+  {
+    float* p = planes[i];
+
+    // Only the corner furthest along the plane normal needs testing
+    float x = p[0] > 0 ? bounds.max.x : bounds.min.x;
+    float y = p[1] > 0 ? bounds.max.y : bounds.min.y;
+    float z = p[2] > 0 ? bounds.max.z : bounds.min.z;
+
+    if(p[0] * x + p[1] * y + p[2] * z + p[3] < 0)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Bounds Frustum::transformBounds(Bounds& bounds, Matrix4x4& matrix)
+{
+  float* m = matrix.getValue();
+  Vector3 center = matrix.multiplyPoint(bounds.center);
+  Vector3 e = bounds.extents;
+
+  // Extents of the rotated box are the absolute basis vectors scaled by the
+  // original extents, which always encloses the transformed box.
+  Vector3 extents(
+    fabs(m[0]) * e.x + fabs(m[4]) * e.y + fabs(m[8]) * e.z,
+    fabs(m[1]) * e.x + fabs(m[5]) * e.y + fabs(m[9]) * e.z,
+    fabs(m[2]) * e.x + fabs(m[6]) * e.y + fabs(m[10]) * e.z);
+
+  return Bounds(center, extents * 2.0f);
+}
+
+}
+
+}
+
+}
+
@@ -0,0 +1,41 @@
+#ifndef MUTINY_ENGINE_INTERNAL_FRUSTUM_H
+#define MUTINY_ENGINE_INTERNAL_FRUSTUM_H
+
+#include "../Matrix4x4.h"
+#include "../Bounds.h"
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+// The six clip planes of a camera in world space, extracted directly from
+// the combined projection and view matrix. Plane normals point inwards so
+// a point is inside when its distance to every plane is positive.
+class Frustum
+{
+public:
+  Frustum();
+
+  void extract(Matrix4x4 matrix);
+  bool testAabb(Bounds& bounds);
+
+  static Bounds transformBounds(Bounds& bounds, Matrix4x4& matrix);
+
+private:
+  float planes[6][4];
+
+};
+
+}
+
+}
+
+}
+
+#endif
+
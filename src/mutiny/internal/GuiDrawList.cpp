@@ -0,0 +1,329 @@
+#include "GuiDrawList.h"
+#include "glmm.h"
+#include "../Application.h"
+#include "../Material.h"
+#include "../Shader.h"
+#include "../Texture.h"
+#include "../RenderTexture.h"
+#include "../Screen.h"
+#include "../Vector3.h"
+#include "OpenGl.h"
+
+#include <algorithm>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+static bool overlaps(Rect& a, Rect& b)
+{
+  if(a.x + a.width <= b.x || b.x + b.width <= a.x) return false;
+  if(a.y + a.height <= b.y || b.y + b.height <= a.y) return false;
+
+  return true;
+}
+
+// Images packed into the same atlas page share a batch
+bool GuiDrawList::sameTexture(Texture* a, Texture* b)
+{
+  if(a == b)
+  {
+    return true;
+  }
+
+  return a->nativeTexture.get() != NULL &&
+    a->nativeTexture.get() == b->nativeTexture.get();
+}
+
+shared<GuiDrawList> GuiDrawList::create()
+{
+  shared<GuiDrawList> rtn;
+
+  rtn.reset(new GuiDrawList());
+
+  return rtn;
+}
+
+GuiDrawList::GuiDrawList()
+{
+  batchCount = 0;
+  bufferSize = 0;
+  bufferOffset = 0;
+  active = false;
+}
+
+void GuiDrawList::begin()
+{
+  active = true;
+}
+
+void GuiDrawList::end()
+{
+  flush();
+  active = false;
+}
+
+void GuiDrawList::add(ref<Texture> texture, std::vector<Rect>& rects,
+  std::vector<Rect>& sourceRects, Matrix4x4 matrix)
+{
+  if(rects.size() < 1)
+  {
+    return;
+  }
+
+  size_t first = vertices.size();
+  Rect& uv = texture->uvRect;
+  float minX = 0;
+  float minY = 0;
+  float maxX = 0;
+  float maxY = 0;
+
+  // Quads are transformed here so batches do not depend on the Gui matrix
+  // that was current when they were queued
+  for(size_t i = 0; i < rects.size(); i++)
+  {
+    Rect& r = rects.at(i);
+
+    // Source rects hold the left, top, right and bottom texture coordinates
+    // of the image which are mapped into its region of an atlas page
+    Rect s(uv.x + sourceRects.at(i).x * uv.width,
+      uv.y + sourceRects.at(i).y * uv.height,
+      uv.x + sourceRects.at(i).width * uv.width,
+      uv.y + sourceRects.at(i).height * uv.height);
+
+    Vector3 a = matrix.multiplyPoint(Vector3(r.x, r.y, 0));
+    Vector3 b = matrix.multiplyPoint(Vector3(r.x, r.y + r.height, 0));
+    Vector3 c = matrix.multiplyPoint(Vector3(r.x + r.width, r.y + r.height, 0));
+    Vector3 d = matrix.multiplyPoint(Vector3(r.x + r.width, r.y, 0));
+
+    float quad[6 * VERTEX_FLOATS] = {
+      a.x, a.y, s.x, s.y,
+      b.x, b.y, s.x, s.height,
+      c.x, c.y, s.width, s.height,
+      c.x, c.y, s.width, s.height,
+      d.x, d.y, s.width, s.y,
+      a.x, a.y, s.x, s.y
+    };
+
+    vertices.insert(vertices.end(), quad, quad + 6 * VERTEX_FLOATS);
+
+    if(i == 0)
+    {
+      minX = maxX = a.x;
+      minY = maxY = a.y;
+    }
+
+    minX = std::min(std::min(minX, a.x), std::min(std::min(b.x, c.x), d.x));
+    minY = std::min(std::min(minY, a.y), std::min(std::min(b.y, c.y), d.y));
+    maxX = std::max(std::max(maxX, a.x), std::max(std::max(b.x, c.x), d.x));
+    maxY = std::max(std::max(maxY, a.y), std::max(std::max(b.y, c.y), d.y));
+  }
+
+  Rect bounds(minX, minY, maxX - minX, maxY - minY);
+  GuiDrawBatch* batch = NULL;
+
+  for(size_t i = batchCount; i > 0 && batchCount - i < MAX_LOOKBACK; i--)
+  {
+    GuiDrawBatch& candidate = batches.at(i - 1);
+
+    if(candidate.texture.valid() &&
+      sameTexture(candidate.texture.get(), texture.get()) == true)
+    {
+      batch = &candidate;
+      break;
+    }
+
+    if(overlaps(candidate.bounds, bounds) == true)
+    {
+      break;
+    }
+  }
+
+  if(batch == NULL)
+  {
+    // Batch storage is kept between frames so its vectors keep capacity
+    if(batchCount >= batches.size())
+    {
+      batches.push_back(GuiDrawBatch());
+    }
+
+    batch = &batches.at(batchCount);
+    batchCount++;
+    batch->texture = texture;
+    batch->bounds = bounds;
+    batch->vertices.clear();
+  }
+  else
+  {
+    float x = std::min(batch->bounds.x, bounds.x);
+    float y = std::min(batch->bounds.y, bounds.y);
+    float xw = std::max(batch->bounds.x + batch->bounds.width, bounds.x + bounds.width);
+    float yh = std::max(batch->bounds.y + batch->bounds.height, bounds.y + bounds.height);
+
+    batch->bounds = Rect(x, y, xw - x, yh - y);
+  }
+
+  batch->vertices.insert(batch->vertices.end(),
+    vertices.begin() + first, vertices.end());
+
+  vertices.resize(first);
+
+  // Outside of the gui phase there is no end of frame flush to wait for
+  if(active == false)
+  {
+    flush();
+  }
+}
+
+size_t GuiDrawList::upload()
+{
+  vertices.clear();
+
+  for(size_t i = 0; i < batchCount; i++)
+  {
+    vertices.insert(vertices.end(), batches.at(i).vertices.begin(),
+      batches.at(i).vertices.end());
+  }
+
+  size_t size = vertices.size() * sizeof(GLfloat);
+
+  if(bufferId.get() == NULL)
+  {
+    bufferId = gl::Uint::genBuffer();
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, bufferId->getGLuint());
+
+  // Writes go to the unused end of the buffer. Once it is full the storage
+  // is orphaned so the driver can hand out a fresh block rather than
+  // stalling on draws still reading from the old one.
+  if(size > bufferSize)
+  {
+    bufferSize = std::max(size * 2, (size_t)MIN_BUFFER_SIZE);
+    bufferOffset = 0;
+    glBufferData(GL_ARRAY_BUFFER, bufferSize, NULL, GL_STREAM_DRAW);
+  }
+  else if(bufferOffset + size > bufferSize)
+  {
+    bufferOffset = 0;
+    glBufferData(GL_ARRAY_BUFFER, bufferSize, NULL, GL_STREAM_DRAW);
+  }
+
+  size_t offset = bufferOffset;
+  glBufferSubData(GL_ARRAY_BUFFER, offset, size, &vertices.at(0));
+  bufferOffset += size;
+  vertices.clear();
+
+  return offset / (VERTEX_FLOATS * sizeof(GLfloat));
+}
+
+void GuiDrawList::flush()
+{
+  if(batchCount < 1)
+  {
+    return;
+  }
+
+  static int projectionId = Shader::propertyToId("in_Projection");
+  static int viewId = Shader::propertyToId("in_View");
+  static int modelId = Shader::propertyToId("in_Model");
+
+  ref<Material> material = Application::context->guiMaterial;
+  ref<Material> currentMaterial = Application::context->currentMaterial;
+  ref<RenderTexture> currentRenderTexture = RenderTexture::getActive();
+  size_t first = upload();
+
+  material->setMatrix(projectionId, Matrix4x4::ortho(0, Screen::getWidth(), Screen::getHeight(), 0, -1, 1));
+  material->setMatrix(viewId, Matrix4x4::getIdentity());
+  material->setMatrix(modelId, Matrix4x4::getIdentity());
+
+  RenderTexture::setActive(Application::context->renderTarget);
+
+  glDisable(GL_DEPTH_TEST);
+  glCullFace(GL_BACK);
+
+  for(size_t i = 0; i < batchCount; i++)
+  {
+    GuiDrawBatch& batch = batches.at(i);
+    GLsizei count = batch.vertices.size() / VERTEX_FLOATS;
+
+    // The texture may have been destroyed since the quads were queued
+    if(batch.texture.expired())
+    {
+      first += count;
+      continue;
+    }
+
+    material->setMainTexture(batch.texture);
+
+    for(int j = 0; j < material->getPassCount(); j++)
+    {
+      material->setPass(j, material);
+
+      // setPass may have bound other buffers so the stream is rebound
+      glBindBuffer(GL_ARRAY_BUFFER, bufferId->getGLuint());
+
+      if(material->positionId != -1)
+      {
+        glVertexAttribPointer(material->positionId, 2, GL_FLOAT, GL_FALSE,
+          VERTEX_FLOATS * sizeof(GLfloat), 0);
+
+        glEnableVertexAttribArray(material->positionId);
+      }
+
+      if(material->uvId != -1)
+      {
+        glVertexAttribPointer(material->uvId, 2, GL_FLOAT, GL_FALSE,
+          VERTEX_FLOATS * sizeof(GLfloat), (GLvoid*)(2 * sizeof(GLfloat)));
+
+        glEnableVertexAttribArray(material->uvId);
+      }
+
+      glDrawArrays(GL_TRIANGLES, first, count);
+    }
+
+    first += count;
+  }
+
+  if(material->positionId != -1)
+  {
+    glDisableVertexAttribArray(material->positionId);
+  }
+
+  if(material->uvId != -1)
+  {
+    glDisableVertexAttribArray(material->uvId);
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glCullFace(GL_FRONT);
+  glEnable(GL_DEPTH_TEST);
+
+  RenderTexture::setActive(currentRenderTexture);
+
+  // A flush from drawMeshNow happens after the caller has set its own pass
+  if(currentMaterial.valid() && currentMaterial.get() != material.get())
+  {
+    currentMaterial->setPass(0, currentMaterial);
+  }
+
+  for(size_t i = 0; i < batchCount; i++)
+  {
+    batches.at(i).texture = ref<Texture>();
+    batches.at(i).vertices.clear();
+  }
+
+  batchCount = 0;
+}
+
+}
+
+}
+
+}
+
@@ -0,0 +1,81 @@
+#ifndef MUTINY_ENGINE_INTERNAL_GUIDRAWLIST_H
+#define MUTINY_ENGINE_INTERNAL_GUIDRAWLIST_H
+
+#include "../Matrix4x4.h"
+#include "../Rect.h"
+#include "../ref.h"
+
+#include <vector>
+
+namespace gl
+{
+  class Uint;
+}
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+class Texture;
+
+namespace internal
+{
+
+class GuiDrawBatch
+{
+public:
+  ref<Texture> texture;
+  Rect bounds;
+  std::vector<float> vertices;
+
+};
+
+// Textured quads drawn through the immediate mode Gui. Rather than issuing
+// a draw for every call they are appended to batches sharing a texture and
+// drawn from one streaming vertex buffer once the gui phase has finished.
+// A quad may join an earlier batch with the same texture only if it does
+// not overlap anything queued after that batch, so the painter's order the
+// Gui relies on is kept.
+class GuiDrawList
+{
+public:
+  static shared<GuiDrawList> create();
+
+  void begin();
+  void end();
+  void add(ref<Texture> texture, std::vector<Rect>& rects,
+    std::vector<Rect>& sourceRects, Matrix4x4 matrix);
+
+  void flush();
+
+private:
+  static const int MAX_LOOKBACK = 16;
+  static const int VERTEX_FLOATS = 4;
+  static const int MIN_BUFFER_SIZE = 256 * 1024;
+
+  std::vector<GuiDrawBatch> batches;
+  size_t batchCount;
+  std::vector<float> vertices;
+  shared<gl::Uint> bufferId;
+  size_t bufferSize;
+  size_t bufferOffset;
+  bool active;
+
+  static bool sameTexture(Texture* a, Texture* b);
+
+  GuiDrawList();
+
+  size_t upload();
+
+};
+
+}
+
+}
+
+}
+
+#endif
+
@@ -0,0 +1,388 @@
+#include "MeshFile.h"
+#include "WavefrontParser.h"
+#include "VertexCache.h"
+#include "CWrapper.h"
+#include "Util.h"
+#include "../Color.h"
+#include "../Exception.h"
+
+#include <sys/stat.h>
+
+#ifndef _WIN32
+  #include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+static const char MAGIC[4] = { 'M', 'M', 'S', 'H' };
+
+static unsigned int addString(std::string& strings, std::string value)
+{
+  unsigned int rtn = strings.length();
+
+  strings += value;
+  strings += '\0';
+
+  return rtn;
+}
+
+static void append(std::vector<char>& output, const void* data, size_t size)
+{
+  output.insert(output.end(), (const char*)data, (const char*)data + size);
+}
+
+template <class T> static void append(std::vector<char>& output, std::vector<T>& values)
+{
+  if(values.size() > 0)
+  {
+    append(output, &values.at(0), values.size() * sizeof(T));
+  }
+}
+
+static void addVertex(VertexCache& cache, VertexData& vertex, Color& color,
+  unsigned int firstVertex, std::vector<unsigned int>& indices)
+{
+  indices.push_back(firstVertex + cache.add(vertex.position, vertex.normal,
+    vertex.coord, color));
+}
+
+shared<MeshFile> MeshFile::load(std::string path)
+{
+  std::string objPath = path + ".obj";
+  std::string meshPath = path + ".mesh";
+  struct stat objInfo;
+  struct stat meshInfo;
+  bool hasObj = stat(objPath.c_str(), &objInfo) == 0;
+  bool hasMesh = stat(meshPath.c_str(), &meshInfo) == 0;
+  shared<MeshFile> rtn(new MeshFile());
+
+  rtn->foldername = Util::getFoldername(path);
+
+  // A binary older than its .obj is stale and gets rebuilt below
+  if(hasMesh == true && (hasObj == false || meshInfo.st_mtime >= objInfo.st_mtime))
+  {
+    try
+    {
+      rtn->file = MappedFile::open(meshPath);
+
+      if(rtn->map((char*)rtn->file->data, rtn->file->size) == true)
+      {
+        return rtn;
+      }
+    }
+    catch(std::exception& e) { }
+
+    rtn->file.reset();
+  }
+
+  WavefrontParser parser(objPath);
+  build(parser.getModelData().get(), rtn->foldername, rtn->buffer);
+
+  if(rtn->map(&rtn->buffer.at(0), rtn->buffer.size()) == false)
+  {
+    throw Exception("Failed to build mesh '" + path + "'");
+  }
+
+  // Leaving the binary behind is only an optimization for next time so a
+  // read only data directory is not an error. It is written aside and
+  // moved into place so a reader never maps a partial file. The temporary
+  // name is unique to this process and load so concurrent writers of the
+  // same model never share one.
+  char suffix[64] = { 0 };
+#ifdef _WIN32
+  unsigned long processId = GetCurrentProcessId();
+#else
+  unsigned long processId = getpid();
+#endif
+  sprintf(suffix, ".%lu.%lx.tmp", processId, (unsigned long)(size_t)rtn.get());
+  std::string tempPath = meshPath + suffix;
+  std::ofstream output(tempPath.c_str(), std::ios::binary);
+
+  if(output.is_open() == true)
+  {
+    output.write(&rtn->buffer.at(0), rtn->buffer.size());
+    output.close();
+
+    if(output.fail() == false)
+    {
+      // Windows will not rename over an existing file
+      if(rename(tempPath.c_str(), meshPath.c_str()) != 0)
+      {
+        remove(meshPath.c_str());
+        rename(tempPath.c_str(), meshPath.c_str());
+      }
+    }
+    else
+    {
+      remove(tempPath.c_str());
+    }
+  }
+
+  return rtn;
+}
+
+void MeshFile::build(ModelData* modelData, std::string foldername,
+  std::vector<char>& output)
+{
+  MeshFileHeader header = {};
+  std::vector<MeshFilePart> parts;
+  std::vector<MeshFileSubmesh> submeshes;
+  std::vector<MeshFileMaterial> materials;
+  std::vector<MeshFileVertex> vertices;
+  std::vector<unsigned int> indices;
+  std::string strings;
+
+  for(size_t m = 0; m < modelData->materials.size(); m++)
+  {
+    ref<MaterialData> materialData = modelData->materials.at(m);
+    MeshFileMaterial material = {};
+    std::string texture = materialData->texture;
+
+    // Stored relative to the model so the data directory can move
+    if(texture.substr(0, foldername.length() + 1) == foldername + "/")
+    {
+      texture = texture.substr(foldername.length() + 1);
+    }
+
+    material.name = addString(strings, materialData->name);
+    material.texture = addString(strings, texture);
+    material.color[0] = materialData->color.x;
+    material.color[1] = materialData->color.y;
+    material.color[2] = materialData->color.z;
+    material.color[3] = materialData->color.w;
+    materials.push_back(material);
+  }
+
+  for(size_t p = 0; p < modelData->parts.size(); p++)
+  {
+    ref<PartData> partData = modelData->parts.at(p);
+    MeshFilePart part = {};
+    VertexCache cache;
+
+    part.name = addString(strings, partData->name);
+    part.firstVertex = vertices.size();
+    part.firstSubmesh = submeshes.size();
+
+    for(size_t g = 0; g < partData->materialGroups.size(); g++)
+    {
+      ref<MaterialGroupData> materialGroup = partData->materialGroups.at(g);
+      MeshFileSubmesh submesh = {};
+      Color color(materialGroup->material->color.x,
+                  materialGroup->material->color.y,
+                  materialGroup->material->color.z);
+
+      for(size_t m = 0; m < modelData->materials.size(); m++)
+      {
+        if(modelData->materials.at(m).get() == materialGroup->material.get())
+        {
+          submesh.material = m;
+          break;
+        }
+      }
+
+      submesh.firstIndex = indices.size();
+
+      for(size_t f = 0; f < materialGroup->faces.size(); f++)
+      {
+        FaceData* face = &materialGroup->faces.at(f);
+
+        addVertex(cache, face->a, color, part.firstVertex, indices);
+        addVertex(cache, face->b, color, part.firstVertex, indices);
+        addVertex(cache, face->c, color, part.firstVertex, indices);
+      }
+
+      submesh.indexCount = indices.size() - submesh.firstIndex;
+      submeshes.push_back(submesh);
+    }
+
+    part.submeshCount = submeshes.size() - part.firstSubmesh;
+    part.vertexCount = cache.vertices.size();
+
+    for(size_t i = 0; i < cache.vertices.size(); i++)
+    {
+      MeshFileVertex vertex = {};
+      float position[3] = { cache.vertices.at(i).x, cache.vertices.at(i).y, cache.vertices.at(i).z };
+
+      for(int c = 0; c < 3; c++)
+      {
+        vertex.position[c] = position[c];
+
+        if(i == 0 || position[c] < part.boundsMin[c]) part.boundsMin[c] = position[c];
+        if(i == 0 || position[c] > part.boundsMax[c]) part.boundsMax[c] = position[c];
+      }
+
+      vertex.normal[0] = cache.normals.at(i).x;
+      vertex.normal[1] = cache.normals.at(i).y;
+      vertex.normal[2] = cache.normals.at(i).z;
+      vertex.uv[0] = cache.uv.at(i).x;
+      vertex.uv[1] = cache.uv.at(i).y;
+      vertex.color[0] = cache.colors.at(i).r;
+      vertex.color[1] = cache.colors.at(i).g;
+      vertex.color[2] = cache.colors.at(i).b;
+      vertex.color[3] = cache.colors.at(i).a;
+      vertices.push_back(vertex);
+    }
+
+    for(int c = 0; c < 3; c++)
+    {
+      if(p == 0 || part.boundsMin[c] < header.boundsMin[c]) header.boundsMin[c] = part.boundsMin[c];
+      if(p == 0 || part.boundsMax[c] > header.boundsMax[c]) header.boundsMax[c] = part.boundsMax[c];
+    }
+
+    parts.push_back(part);
+  }
+
+  memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.partCount = parts.size();
+  header.submeshCount = submeshes.size();
+  header.materialCount = materials.size();
+  header.vertexCount = vertices.size();
+  header.indexCount = indices.size();
+  header.stringsSize = strings.length();
+
+  output.clear();
+  append(output, &header, sizeof(header));
+  append(output, parts);
+  append(output, submeshes);
+  append(output, materials);
+  append(output, vertices);
+  append(output, indices);
+  append(output, strings.c_str(), strings.length());
+}
+
+MeshFile::MeshFile()
+{
+  header = NULL;
+  parts = NULL;
+  submeshes = NULL;
+  materials = NULL;
+  vertices = NULL;
+  indices = NULL;
+  strings = NULL;
+}
+
+bool MeshFile::map(char* data, size_t size)
+{
+  if(size < sizeof(MeshFileHeader))
+  {
+    return false;
+  }
+
+  header = (MeshFileHeader*)data;
+
+  if(memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION)
+  {
+    return false;
+  }
+
+  size_t offset = sizeof(MeshFileHeader);
+
+  if(size < offset + (size_t)header->partCount * sizeof(MeshFilePart) +
+    (size_t)header->submeshCount * sizeof(MeshFileSubmesh) +
+    (size_t)header->materialCount * sizeof(MeshFileMaterial) +
+    (size_t)header->vertexCount * sizeof(MeshFileVertex) +
+    (size_t)header->indexCount * sizeof(unsigned int) + header->stringsSize)
+  {
+    return false;
+  }
+
+  parts = (MeshFilePart*)(data + offset);
+  offset += header->partCount * sizeof(MeshFilePart);
+  submeshes = (MeshFileSubmesh*)(data + offset);
+  offset += header->submeshCount * sizeof(MeshFileSubmesh);
+  materials = (MeshFileMaterial*)(data + offset);
+  offset += header->materialCount * sizeof(MeshFileMaterial);
+  vertices = (MeshFileVertex*)(data + offset);
+  offset += header->vertexCount * sizeof(MeshFileVertex);
+  indices = (unsigned int*)(data + offset);
+  offset += header->indexCount * sizeof(unsigned int);
+  strings = data + offset;
+
+  // Nothing below is parsed but a damaged file must not index out of the
+  // mapping, so every range and reference is checked once here
+  if(header->stringsSize > 0 && strings[header->stringsSize - 1] != '\0')
+  {
+    return false;
+  }
+
+  for(unsigned int i = 0; i < header->materialCount; i++)
+  {
+    if(materials[i].name >= header->stringsSize) return false;
+    if(materials[i].texture >= header->stringsSize) return false;
+  }
+
+  // The vertices each submesh may index. Parts are loaded as meshes of their
+  // own so a submesh belonging to one is limited to that part's range.
+  std::vector<unsigned int> firstVertex(header->submeshCount, 0);
+  std::vector<unsigned int> lastVertex(header->submeshCount, header->vertexCount);
+
+  for(unsigned int i = 0; i < header->partCount; i++)
+  {
+    if(parts[i].name >= header->stringsSize) return false;
+    if(parts[i].firstVertex > header->vertexCount) return false;
+    if(parts[i].vertexCount > header->vertexCount - parts[i].firstVertex) return false;
+    if(parts[i].firstSubmesh > header->submeshCount) return false;
+    if(parts[i].submeshCount > header->submeshCount - parts[i].firstSubmesh) return false;
+
+    for(unsigned int s = parts[i].firstSubmesh; s < parts[i].firstSubmesh + parts[i].submeshCount; s++)
+    {
+      firstVertex[s] = std::max(firstVertex[s], parts[i].firstVertex);
+      lastVertex[s] = std::min(lastVertex[s], parts[i].firstVertex + parts[i].vertexCount);
+    }
+  }
+
+  // Indices outside of every submesh are never read so each one that is
+  // gets checked exactly once
+  for(unsigned int i = 0; i < header->submeshCount; i++)
+  {
+    if(submeshes[i].material >= header->materialCount) return false;
+    if(submeshes[i].firstIndex > header->indexCount) return false;
+    if(submeshes[i].indexCount > header->indexCount - submeshes[i].firstIndex) return false;
+
+    unsigned int* first = indices + submeshes[i].firstIndex;
+
+    for(unsigned int j = 0; j < submeshes[i].indexCount; j++)
+    {
+      if(first[j] < firstVertex[i] || first[j] >= lastVertex[i]) return false;
+    }
+  }
+
+  return true;
+}
+
+std::string MeshFile::getString(unsigned int offset)
+{
+  return strings + offset;
+}
+
+std::string MeshFile::getTexture(unsigned int material)
+{
+  std::string texture = getString(materials[material].texture);
+
+  if(texture == "")
+  {
+    return texture;
+  }
+
+  return foldername + "/" + texture;
+}
+
+}
+
+}
+
+}
+
@@ -0,0 +1,113 @@
+#ifndef MUTINY_ENGINE_INTERNAL_MESHFILE_H
+#define MUTINY_ENGINE_INTERNAL_MESHFILE_H
+
+#include "../ref.h"
+
+#include <string>
+#include <vector>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+struct MappedFile;
+struct ModelData;
+
+struct MeshFileHeader
+{
+  char magic[4];
+  unsigned int version;
+  unsigned int partCount;
+  unsigned int submeshCount;
+  unsigned int materialCount;
+  unsigned int vertexCount;
+  unsigned int indexCount;
+  unsigned int stringsSize;
+  float boundsMin[3];
+  float boundsMax[3];
+};
+
+struct MeshFilePart
+{
+  unsigned int name;
+  unsigned int firstVertex;
+  unsigned int vertexCount;
+  unsigned int firstSubmesh;
+  unsigned int submeshCount;
+  float boundsMin[3];
+  float boundsMax[3];
+};
+
+struct MeshFileSubmesh
+{
+  unsigned int material;
+  unsigned int firstIndex;
+  unsigned int indexCount;
+};
+
+struct MeshFileMaterial
+{
+  unsigned int name;
+  unsigned int texture;
+  float color[4];
+};
+
+struct MeshFileVertex
+{
+  float position[3];
+  float normal[3];
+  float uv[2];
+  float color[4];
+};
+
+// Binary form of a model, written beside the .obj the first time it is
+// parsed. The header is followed by the part, submesh and material tables,
+// the interleaved vertex stream, the indices and a table of null
+// terminated strings, so a load is a single mapping of the file with the
+// arrays used in place. Indices refer to the whole vertex stream and each
+// part owns a contiguous range of it.
+class MeshFile
+{
+public:
+  static shared<MeshFile> load(std::string path);
+
+  MeshFileHeader* header;
+  MeshFilePart* parts;
+  MeshFileSubmesh* submeshes;
+  MeshFileMaterial* materials;
+  MeshFileVertex* vertices;
+  unsigned int* indices;
+
+  std::string getString(unsigned int offset);
+  std::string getTexture(unsigned int material);
+
+private:
+  static const unsigned int VERSION = 1;
+
+  static void build(ModelData* modelData, std::string foldername,
+    std::vector<char>& output);
+
+  shared<MappedFile> file;
+  std::vector<char> buffer;
+  std::string foldername;
+  char* strings;
+
+  MeshFile();
+
+  bool map(char* data, size_t size);
+
+};
+
+}
+
+}
+
+}
+
+#endif
+
@@ -0,0 +1,253 @@
+#include "platform.h"
+
+#ifdef USE_HEADLESS
+
+#include "NullGl.h"
+
+// Headless builds are not linked against GL, GLEW or GLUT. Instead this unit
+// provides every entry point the engine uses. Object names are handed out so
+// that gl::Uint allocations succeed, shaders always compile and link and
+// every attribute and uniform resolves to location 0 so that the CPU side of
+// rendering runs exactly as it would with a real context.
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+GLuint nullGlNextName = 1;
+
+void nullGlGenNames(GLsizei n, GLuint* names)
+{
+  for(GLsizei i = 0; i < n; i++)
+  {
+    names[i] = nullGlNextName;
+    nullGlNextName++;
+  }
+}
+
+}
+
+}
+
+}
+
+using mutiny::engine::internal::nullGlGenNames;
+using mutiny::engine::internal::nullGlNextName;
+
+extern "C"
+{
+
+GLboolean glewExperimental = GL_FALSE;
+
+GLenum GLEWAPIENTRY glewInit(void)
+{
+  return GLEW_OK;
+}
+
+// OpenGL 1.1 entry points normally exported by the GL library
+
+void GLAPIENTRY glEnable(GLenum cap) { }
+void GLAPIENTRY glDisable(GLenum cap) { }
+void GLAPIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor) { }
+void GLAPIENTRY glCullFace(GLenum mode) { }
+void GLAPIENTRY glViewport(GLint x, GLint y, GLsizei width, GLsizei height) { }
+void GLAPIENTRY glClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha) { }
+void GLAPIENTRY glClear(GLbitfield mask) { }
+void GLAPIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count) { }
+
+void GLAPIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type,
+  const GLvoid* indices) { }
+
+void GLAPIENTRY glGetIntegerv(GLenum pname, GLint* params)
+{
+  *params = pname == GL_MAX_VERTEX_ATTRIBS ? 16 : 0;
+}
+
+const GLubyte* GLAPIENTRY glGetString(GLenum name)
+{
+  if(name == GL_VERSION)
+  {
+    return (const GLubyte*)"3.3 Null";
+  }
+
+  return (const GLubyte*)"";
+}
+
+void GLAPIENTRY glBindTexture(GLenum target, GLuint texture) { }
+void GLAPIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param) { }
+
+void GLAPIENTRY glTexImage2D(GLenum target, GLint level, GLint internalFormat,
+  GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type,
+  const GLvoid* pixels) { }
+
+void GLAPIENTRY glTexSubImage2D(GLenum target, GLint level, GLint xoffset,
+  GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type,
+  const GLvoid* pixels) { }
+
+void GLAPIENTRY glGenTextures(GLsizei n, GLuint* textures)
+{
+  nullGlGenNames(n, textures);
+}
+
+void GLAPIENTRY glDeleteTextures(GLsizei n, const GLuint* textures) { }
+
+// Extension entry points normally resolved by glewInit
+
+static void GLAPIENTRY nullGenNames(GLsizei n, GLuint* names)
+{
+  nullGlGenNames(n, names);
+}
+
+static void GLAPIENTRY nullDeleteNames(GLsizei n, const GLuint* names) { }
+
+static GLuint GLAPIENTRY nullCreateShader(GLenum type)
+{
+  nullGlNextName++;
+
+  return nullGlNextName - 1;
+}
+
+static GLuint GLAPIENTRY nullCreateProgram(void)
+{
+  nullGlNextName++;
+
+  return nullGlNextName - 1;
+}
+
+static void GLAPIENTRY nullObject(GLuint object) { }
+
+static void GLAPIENTRY nullGetObjectiv(GLuint object, GLenum pname, GLint* params)
+{
+  if(pname == GL_COMPILE_STATUS || pname == GL_LINK_STATUS)
+  {
+    *params = GL_TRUE;
+  }
+  else
+  {
+    *params = 0;
+  }
+}
+
+static void GLAPIENTRY nullGetInfoLog(GLuint object, GLsizei bufSize,
+  GLsizei* length, GLchar* infoLog)
+{
+  if(length != NULL) *length = 0;
+  if(bufSize > 0) infoLog[0] = '\0';
+}
+
+static void GLAPIENTRY nullShaderSource(GLuint shader, GLsizei count,
+  const GLchar* const* string, const GLint* length) { }
+
+static void GLAPIENTRY nullAttachShader(GLuint program, GLuint shader) { }
+
+static GLint GLAPIENTRY nullGetLocation(GLuint program, const GLchar* name)
+{
+  return 0;
+}
+
+static void GLAPIENTRY nullUseProgram(GLuint program) { }
+static void GLAPIENTRY nullBindBuffer(GLenum target, GLuint buffer) { }
+
+static void GLAPIENTRY nullBufferData(GLenum target, GLsizeiptr size,
+  const GLvoid* data, GLenum usage) { }
+
+static void GLAPIENTRY nullBufferSubData(GLenum target, GLintptr offset,
+  GLsizeiptr size, const GLvoid* data) { }
+
+static void GLAPIENTRY nullVertexAttribPointer(GLuint index, GLint size,
+  GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer) { }
+
+static void GLAPIENTRY nullVertexAttribArray(GLuint index) { }
+
+static void GLAPIENTRY nullUniformMatrix4fv(GLint location, GLsizei count,
+  GLboolean transpose, const GLfloat* value) { }
+
+static void GLAPIENTRY nullUniform1f(GLint location, GLfloat v0) { }
+static void GLAPIENTRY nullUniform2f(GLint location, GLfloat v0, GLfloat v1) { }
+static void GLAPIENTRY nullUniform1i(GLint location, GLint v0) { }
+static void GLAPIENTRY nullActiveTexture(GLenum texture) { }
+static void GLAPIENTRY nullBindFramebuffer(GLenum target, GLuint framebuffer) { }
+static void GLAPIENTRY nullBindRenderbuffer(GLenum target, GLuint renderbuffer) { }
+
+static void GLAPIENTRY nullRenderbufferStorage(GLenum target,
+  GLenum internalformat, GLsizei width, GLsizei height) { }
+
+static void GLAPIENTRY nullFramebufferRenderbuffer(GLenum target,
+  GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) { }
+
+static void GLAPIENTRY nullFramebufferTexture2D(GLenum target,
+  GLenum attachment, GLenum textarget, GLuint texture, GLint level) { }
+
+static GLenum GLAPIENTRY nullCheckFramebufferStatus(GLenum target)
+{
+  return GL_FRAMEBUFFER_COMPLETE;
+}
+
+static void GLAPIENTRY nullGenerateMipmap(GLenum target) { }
+static void GLAPIENTRY nullBindVertexArray(GLuint array) { }
+static void GLAPIENTRY nullVertexAttrib4fv(GLuint index, const GLfloat* v) { }
+static void GLAPIENTRY nullVertexAttribDivisor(GLuint index, GLuint divisor) { }
+
+static void GLAPIENTRY nullBindAttribLocation(GLuint program, GLuint index,
+  const GLchar* name) { }
+
+static void GLAPIENTRY nullDrawElementsInstanced(GLenum mode, GLsizei count,
+  GLenum type, const GLvoid* indices, GLsizei primcount) { }
+
+PFNGLGENBUFFERSPROC __glewGenBuffers = nullGenNames;
+PFNGLDELETEBUFFERSPROC __glewDeleteBuffers = nullDeleteNames;
+PFNGLBINDBUFFERPROC __glewBindBuffer = nullBindBuffer;
+PFNGLBUFFERDATAPROC __glewBufferData = nullBufferData;
+PFNGLBUFFERSUBDATAPROC __glewBufferSubData = nullBufferSubData;
+PFNGLGENFRAMEBUFFERSPROC __glewGenFramebuffers = nullGenNames;
+PFNGLDELETEFRAMEBUFFERSPROC __glewDeleteFramebuffers = nullDeleteNames;
+PFNGLBINDFRAMEBUFFERPROC __glewBindFramebuffer = nullBindFramebuffer;
+PFNGLCHECKFRAMEBUFFERSTATUSPROC __glewCheckFramebufferStatus = nullCheckFramebufferStatus;
+PFNGLFRAMEBUFFERTEXTURE2DPROC __glewFramebufferTexture2D = nullFramebufferTexture2D;
+PFNGLFRAMEBUFFERRENDERBUFFERPROC __glewFramebufferRenderbuffer = nullFramebufferRenderbuffer;
+PFNGLGENRENDERBUFFERSPROC __glewGenRenderbuffers = nullGenNames;
+PFNGLDELETERENDERBUFFERSPROC __glewDeleteRenderbuffers = nullDeleteNames;
+PFNGLBINDRENDERBUFFERPROC __glewBindRenderbuffer = nullBindRenderbuffer;
+PFNGLRENDERBUFFERSTORAGEPROC __glewRenderbufferStorage = nullRenderbufferStorage;
+PFNGLGENERATEMIPMAPPROC __glewGenerateMipmap = nullGenerateMipmap;
+PFNGLGENERATEMIPMAPEXTPROC __glewGenerateMipmapEXT = nullGenerateMipmap;
+PFNGLGENVERTEXARRAYSPROC __glewGenVertexArrays = nullGenNames;
+PFNGLBINDVERTEXARRAYPROC __glewBindVertexArray = nullBindVertexArray;
+PFNGLDELETEVERTEXARRAYSPROC __glewDeleteVertexArrays = nullDeleteNames;
+PFNGLCREATESHADERPROC __glewCreateShader = nullCreateShader;
+PFNGLDELETESHADERPROC __glewDeleteShader = nullObject;
+PFNGLSHADERSOURCEPROC __glewShaderSource = nullShaderSource;
+PFNGLCOMPILESHADERPROC __glewCompileShader = nullObject;
+PFNGLGETSHADERIVPROC __glewGetShaderiv = nullGetObjectiv;
+PFNGLGETSHADERINFOLOGPROC __glewGetShaderInfoLog = nullGetInfoLog;
+PFNGLCREATEPROGRAMPROC __glewCreateProgram = nullCreateProgram;
+PFNGLDELETEPROGRAMPROC __glewDeleteProgram = nullObject;
+PFNGLATTACHSHADERPROC __glewAttachShader = nullAttachShader;
+PFNGLDETACHSHADERPROC __glewDetachShader = nullAttachShader;
+PFNGLLINKPROGRAMPROC __glewLinkProgram = nullObject;
+PFNGLGETPROGRAMIVPROC __glewGetProgramiv = nullGetObjectiv;
+PFNGLGETPROGRAMINFOLOGPROC __glewGetProgramInfoLog = nullGetInfoLog;
+PFNGLUSEPROGRAMPROC __glewUseProgram = nullUseProgram;
+PFNGLGETATTRIBLOCATIONPROC __glewGetAttribLocation = nullGetLocation;
+PFNGLGETUNIFORMLOCATIONPROC __glewGetUniformLocation = nullGetLocation;
+PFNGLVERTEXATTRIBPOINTERPROC __glewVertexAttribPointer = nullVertexAttribPointer;
+PFNGLENABLEVERTEXATTRIBARRAYPROC __glewEnableVertexAttribArray = nullVertexAttribArray;
+PFNGLDISABLEVERTEXATTRIBARRAYPROC __glewDisableVertexAttribArray = nullVertexAttribArray;
+PFNGLUNIFORMMATRIX4FVPROC __glewUniformMatrix4fv = nullUniformMatrix4fv;
+PFNGLUNIFORM1FPROC __glewUniform1f = nullUniform1f;
+PFNGLUNIFORM2FPROC __glewUniform2f = nullUniform2f;
+PFNGLUNIFORM1IPROC __glewUniform1i = nullUniform1i;
+PFNGLACTIVETEXTUREPROC __glewActiveTexture = nullActiveTexture;
+PFNGLVERTEXATTRIB4FVPROC __glewVertexAttrib4fv = nullVertexAttrib4fv;
+PFNGLVERTEXATTRIBDIVISORPROC __glewVertexAttribDivisor = nullVertexAttribDivisor;
+PFNGLBINDATTRIBLOCATIONPROC __glewBindAttribLocation = nullBindAttribLocation;
+PFNGLDRAWELEMENTSINSTANCEDPROC __glewDrawElementsInstanced = nullDrawElementsInstanced;
+
+}
+
+#endif
@@ -0,0 +1,306 @@
+#ifndef MUTINY_ENGINE_INTERNAL_NULLGL_H
+#define MUTINY_ENGINE_INTERNAL_NULLGL_H
+
+// The subset of the GL and GLEW headers that the engine uses, declared here
+// so that headless builds need no GL development headers installed. It keeps
+// the shape of GLEW, with extension entry points called through __glew
+// function pointers, so that code compiles the same either way. Everything
+// declared here is defined in NullGl.cpp.
+
+#include <cstddef>
+
+#define GLAPIENTRY
+#define GLEWAPIENTRY
+
+typedef unsigned int GLenum;
+typedef unsigned char GLboolean;
+typedef unsigned int GLbitfield;
+typedef void GLvoid;
+typedef int GLint;
+typedef int GLsizei;
+typedef unsigned char GLubyte;
+typedef unsigned short GLushort;
+typedef unsigned int GLuint;
+typedef float GLfloat;
+typedef float GLclampf;
+typedef char GLchar;
+typedef ptrdiff_t GLintptr;
+typedef ptrdiff_t GLsizeiptr;
+
+#define GL_FALSE 0
+#define GL_TRUE 1
+
+#define GL_DEPTH_BUFFER_BIT 0x00000100
+#define GL_COLOR_BUFFER_BIT 0x00004000
+#define GL_TRIANGLES 0x0004
+#define GL_SRC_ALPHA 0x0302
+#define GL_ONE_MINUS_SRC_ALPHA 0x0303
+#define GL_FRONT 0x0404
+#define GL_BACK 0x0405
+#define GL_CULL_FACE 0x0B44
+#define GL_DEPTH_TEST 0x0B71
+#define GL_BLEND 0x0BE2
+#define GL_TEXTURE_2D 0x0DE1
+#define GL_UNSIGNED_BYTE 0x1401
+#define GL_UNSIGNED_SHORT 0x1403
+#define GL_UNSIGNED_INT 0x1405
+#define GL_FLOAT 0x1406
+#define GL_RGBA 0x1908
+#define GL_VERSION 0x1F02
+#define GL_EXTENSIONS 0x1F03
+#define GL_NEAREST 0x2600
+#define GL_LINEAR 0x2601
+#define GL_LINEAR_MIPMAP_LINEAR 0x2703
+#define GL_TEXTURE_MAG_FILTER 0x2800
+#define GL_TEXTURE_MIN_FILTER 0x2801
+#define GL_TEXTURE_WRAP_S 0x2802
+#define GL_TEXTURE_WRAP_T 0x2803
+#define GL_CLAMP 0x2900
+#define GL_REPEAT 0x2901
+#define GL_GENERATE_MIPMAP 0x8191
+#define GL_DEPTH_COMPONENT16 0x81A5
+#define GL_TEXTURE0 0x84C0
+#define GL_MAX_VERTEX_ATTRIBS 0x8869
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#define GL_STREAM_DRAW 0x88E0
+#define GL_STATIC_DRAW 0x88E4
+#define GL_DYNAMIC_DRAW 0x88E8
+#define GL_FRAGMENT_SHADER 0x8B30
+#define GL_VERTEX_SHADER 0x8B31
+#define GL_FLOAT_VEC2 0x8B50
+#define GL_FLOAT_MAT4 0x8B5C
+#define GL_SAMPLER_2D 0x8B5E
+#define GL_COMPILE_STATUS 0x8B81
+#define GL_LINK_STATUS 0x8B82
+#define GL_INFO_LOG_LENGTH 0x8B84
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#define GL_DEPTH_ATTACHMENT 0x8D00
+#define GL_FRAMEBUFFER 0x8D40
+#define GL_RENDERBUFFER 0x8D41
+
+#define GLEW_OK 0
+
+extern "C"
+{
+
+extern GLboolean glewExperimental;
+GLenum GLEWAPIENTRY glewInit(void);
+
+// OpenGL 1.1 entry points
+
+void GLAPIENTRY glEnable(GLenum cap);
+void GLAPIENTRY glDisable(GLenum cap);
+void GLAPIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor);
+void GLAPIENTRY glCullFace(GLenum mode);
+void GLAPIENTRY glViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+void GLAPIENTRY glClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha);
+void GLAPIENTRY glClear(GLbitfield mask);
+void GLAPIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count);
+
+void GLAPIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type,
+  const GLvoid* indices);
+
+void GLAPIENTRY glGetIntegerv(GLenum pname, GLint* params);
+const GLubyte* GLAPIENTRY glGetString(GLenum name);
+void GLAPIENTRY glBindTexture(GLenum target, GLuint texture);
+void GLAPIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param);
+
+void GLAPIENTRY glTexImage2D(GLenum target, GLint level, GLint internalFormat,
+  GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type,
+  const GLvoid* pixels);
+
+void GLAPIENTRY glTexSubImage2D(GLenum target, GLint level, GLint xoffset,
+  GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type,
+  const GLvoid* pixels);
+
+void GLAPIENTRY glGenTextures(GLsizei n, GLuint* textures);
+void GLAPIENTRY glDeleteTextures(GLsizei n, const GLuint* textures);
+
+// Extension entry points
+
+typedef void (GLAPIENTRY* PFNGLGENBUFFERSPROC)(GLsizei n, GLuint* buffers);
+typedef void (GLAPIENTRY* PFNGLDELETEBUFFERSPROC)(GLsizei n, const GLuint* buffers);
+typedef void (GLAPIENTRY* PFNGLBINDBUFFERPROC)(GLenum target, GLuint buffer);
+
+typedef void (GLAPIENTRY* PFNGLBUFFERDATAPROC)(GLenum target, GLsizeiptr size,
+  const GLvoid* data, GLenum usage);
+
+typedef void (GLAPIENTRY* PFNGLBUFFERSUBDATAPROC)(GLenum target,
+  GLintptr offset, GLsizeiptr size, const GLvoid* data);
+
+typedef void (GLAPIENTRY* PFNGLGENFRAMEBUFFERSPROC)(GLsizei n, GLuint* framebuffers);
+typedef void (GLAPIENTRY* PFNGLDELETEFRAMEBUFFERSPROC)(GLsizei n, const GLuint* framebuffers);
+typedef void (GLAPIENTRY* PFNGLBINDFRAMEBUFFERPROC)(GLenum target, GLuint framebuffer);
+typedef GLenum (GLAPIENTRY* PFNGLCHECKFRAMEBUFFERSTATUSPROC)(GLenum target);
+
+typedef void (GLAPIENTRY* PFNGLFRAMEBUFFERTEXTURE2DPROC)(GLenum target,
+  GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+
+typedef void (GLAPIENTRY* PFNGLFRAMEBUFFERRENDERBUFFERPROC)(GLenum target,
+  GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer);
+
+typedef void (GLAPIENTRY* PFNGLGENRENDERBUFFERSPROC)(GLsizei n, GLuint* renderbuffers);
+typedef void (GLAPIENTRY* PFNGLDELETERENDERBUFFERSPROC)(GLsizei n, const GLuint* renderbuffers);
+typedef void (GLAPIENTRY* PFNGLBINDRENDERBUFFERPROC)(GLenum target, GLuint renderbuffer);
+
+typedef void (GLAPIENTRY* PFNGLRENDERBUFFERSTORAGEPROC)(GLenum target,
+  GLenum internalformat, GLsizei width, GLsizei height);
+
+typedef void (GLAPIENTRY* PFNGLGENERATEMIPMAPPROC)(GLenum target);
+typedef void (GLAPIENTRY* PFNGLGENERATEMIPMAPEXTPROC)(GLenum target);
+typedef void (GLAPIENTRY* PFNGLGENVERTEXARRAYSPROC)(GLsizei n, GLuint* arrays);
+typedef void (GLAPIENTRY* PFNGLBINDVERTEXARRAYPROC)(GLuint array);
+typedef void (GLAPIENTRY* PFNGLDELETEVERTEXARRAYSPROC)(GLsizei n, const GLuint* arrays);
+typedef GLuint (GLAPIENTRY* PFNGLCREATESHADERPROC)(GLenum type);
+typedef void (GLAPIENTRY* PFNGLDELETESHADERPROC)(GLuint shader);
+
+typedef void (GLAPIENTRY* PFNGLSHADERSOURCEPROC)(GLuint shader, GLsizei count,
+  const GLchar* const* string, const GLint* length);
+
+typedef void (GLAPIENTRY* PFNGLCOMPILESHADERPROC)(GLuint shader);
+typedef void (GLAPIENTRY* PFNGLGETSHADERIVPROC)(GLuint shader, GLenum pname, GLint* params);
+
+typedef void (GLAPIENTRY* PFNGLGETSHADERINFOLOGPROC)(GLuint shader,
+  GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+
+typedef GLuint (GLAPIENTRY* PFNGLCREATEPROGRAMPROC)(void);
+typedef void (GLAPIENTRY* PFNGLDELETEPROGRAMPROC)(GLuint program);
+typedef void (GLAPIENTRY* PFNGLATTACHSHADERPROC)(GLuint program, GLuint shader);
+typedef void (GLAPIENTRY* PFNGLDETACHSHADERPROC)(GLuint program, GLuint shader);
+typedef void (GLAPIENTRY* PFNGLLINKPROGRAMPROC)(GLuint program);
+typedef void (GLAPIENTRY* PFNGLGETPROGRAMIVPROC)(GLuint program, GLenum pname, GLint* params);
+
+typedef void (GLAPIENTRY* PFNGLGETPROGRAMINFOLOGPROC)(GLuint program,
+  GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+
+typedef void (GLAPIENTRY* PFNGLUSEPROGRAMPROC)(GLuint program);
+typedef GLint (GLAPIENTRY* PFNGLGETATTRIBLOCATIONPROC)(GLuint program, const GLchar* name);
+typedef GLint (GLAPIENTRY* PFNGLGETUNIFORMLOCATIONPROC)(GLuint program, const GLchar* name);
+
+typedef void (GLAPIENTRY* PFNGLVERTEXATTRIBPOINTERPROC)(GLuint index,
+  GLint size, GLenum type, GLboolean normalized, GLsizei stride,
+  const GLvoid* pointer);
+
+typedef void (GLAPIENTRY* PFNGLENABLEVERTEXATTRIBARRAYPROC)(GLuint index);
+typedef void (GLAPIENTRY* PFNGLDISABLEVERTEXATTRIBARRAYPROC)(GLuint index);
+
+typedef void (GLAPIENTRY* PFNGLUNIFORMMATRIX4FVPROC)(GLint location,
+  GLsizei count, GLboolean transpose, const GLfloat* value);
+
+typedef void (GLAPIENTRY* PFNGLUNIFORM1FPROC)(GLint location, GLfloat v0);
+typedef void (GLAPIENTRY* PFNGLUNIFORM2FPROC)(GLint location, GLfloat v0, GLfloat v1);
+typedef void (GLAPIENTRY* PFNGLUNIFORM1IPROC)(GLint location, GLint v0);
+typedef void (GLAPIENTRY* PFNGLACTIVETEXTUREPROC)(GLenum texture);
+typedef void (GLAPIENTRY* PFNGLVERTEXATTRIB4FVPROC)(GLuint index, const GLfloat* v);
+typedef void (GLAPIENTRY* PFNGLVERTEXATTRIBDIVISORPROC)(GLuint index, GLuint divisor);
+
+typedef void (GLAPIENTRY* PFNGLBINDATTRIBLOCATIONPROC)(GLuint program,
+  GLuint index, const GLchar* name);
+
+typedef void (GLAPIENTRY* PFNGLDRAWELEMENTSINSTANCEDPROC)(GLenum mode,
+  GLsizei count, GLenum type, const GLvoid* indices, GLsizei primcount);
+
+extern PFNGLGENBUFFERSPROC __glewGenBuffers;
+extern PFNGLDELETEBUFFERSPROC __glewDeleteBuffers;
+extern PFNGLBINDBUFFERPROC __glewBindBuffer;
+extern PFNGLBUFFERDATAPROC __glewBufferData;
+extern PFNGLBUFFERSUBDATAPROC __glewBufferSubData;
+extern PFNGLGENFRAMEBUFFERSPROC __glewGenFramebuffers;
+extern PFNGLDELETEFRAMEBUFFERSPROC __glewDeleteFramebuffers;
+extern PFNGLBINDFRAMEBUFFERPROC __glewBindFramebuffer;
+extern PFNGLCHECKFRAMEBUFFERSTATUSPROC __glewCheckFramebufferStatus;
+extern PFNGLFRAMEBUFFERTEXTURE2DPROC __glewFramebufferTexture2D;
+extern PFNGLFRAMEBUFFERRENDERBUFFERPROC __glewFramebufferRenderbuffer;
+extern PFNGLGENRENDERBUFFERSPROC __glewGenRenderbuffers;
+extern PFNGLDELETERENDERBUFFERSPROC __glewDeleteRenderbuffers;
+extern PFNGLBINDRENDERBUFFERPROC __glewBindRenderbuffer;
+extern PFNGLRENDERBUFFERSTORAGEPROC __glewRenderbufferStorage;
+extern PFNGLGENERATEMIPMAPPROC __glewGenerateMipmap;
+extern PFNGLGENERATEMIPMAPEXTPROC __glewGenerateMipmapEXT;
+extern PFNGLGENVERTEXARRAYSPROC __glewGenVertexArrays;
+extern PFNGLBINDVERTEXARRAYPROC __glewBindVertexArray;
+extern PFNGLDELETEVERTEXARRAYSPROC __glewDeleteVertexArrays;
+extern PFNGLCREATESHADERPROC __glewCreateShader;
+extern PFNGLDELETESHADERPROC __glewDeleteShader;
+extern PFNGLSHADERSOURCEPROC __glewShaderSource;
+extern PFNGLCOMPILESHADERPROC __glewCompileShader;
+extern PFNGLGETSHADERIVPROC __glewGetShaderiv;
+extern PFNGLGETSHADERINFOLOGPROC __glewGetShaderInfoLog;
+extern PFNGLCREATEPROGRAMPROC __glewCreateProgram;
+extern PFNGLDELETEPROGRAMPROC __glewDeleteProgram;
+extern PFNGLATTACHSHADERPROC __glewAttachShader;
+extern PFNGLDETACHSHADERPROC __glewDetachShader;
+extern PFNGLLINKPROGRAMPROC __glewLinkProgram;
+extern PFNGLGETPROGRAMIVPROC __glewGetProgramiv;
+extern PFNGLGETPROGRAMINFOLOGPROC __glewGetProgramInfoLog;
+extern PFNGLUSEPROGRAMPROC __glewUseProgram;
+extern PFNGLGETATTRIBLOCATIONPROC __glewGetAttribLocation;
+extern PFNGLGETUNIFORMLOCATIONPROC __glewGetUniformLocation;
+extern PFNGLVERTEXATTRIBPOINTERPROC __glewVertexAttribPointer;
+extern PFNGLENABLEVERTEXATTRIBARRAYPROC __glewEnableVertexAttribArray;
+extern PFNGLDISABLEVERTEXATTRIBARRAYPROC __glewDisableVertexAttribArray;
+extern PFNGLUNIFORMMATRIX4FVPROC __glewUniformMatrix4fv;
+extern PFNGLUNIFORM1FPROC __glewUniform1f;
+extern PFNGLUNIFORM2FPROC __glewUniform2f;
+extern PFNGLUNIFORM1IPROC __glewUniform1i;
+extern PFNGLACTIVETEXTUREPROC __glewActiveTexture;
+extern PFNGLVERTEXATTRIB4FVPROC __glewVertexAttrib4fv;
+extern PFNGLVERTEXATTRIBDIVISORPROC __glewVertexAttribDivisor;
+extern PFNGLBINDATTRIBLOCATIONPROC __glewBindAttribLocation;
+extern PFNGLDRAWELEMENTSINSTANCEDPROC __glewDrawElementsInstanced;
+
+}
+
+#define glGenBuffers __glewGenBuffers
+#define glDeleteBuffers __glewDeleteBuffers
+#define glBindBuffer __glewBindBuffer
+#define glBufferData __glewBufferData
+#define glBufferSubData __glewBufferSubData
+#define glGenFramebuffers __glewGenFramebuffers
+#define glDeleteFramebuffers __glewDeleteFramebuffers
+#define glBindFramebuffer __glewBindFramebuffer
+#define glCheckFramebufferStatus __glewCheckFramebufferStatus
+#define glFramebufferTexture2D __glewFramebufferTexture2D
+#define glFramebufferRenderbuffer __glewFramebufferRenderbuffer
+#define glGenRenderbuffers __glewGenRenderbuffers
+#define glDeleteRenderbuffers __glewDeleteRenderbuffers
+#define glBindRenderbuffer __glewBindRenderbuffer
+#define glRenderbufferStorage __glewRenderbufferStorage
+#define glGenerateMipmap __glewGenerateMipmap
+#define glGenerateMipmapEXT __glewGenerateMipmapEXT
+#define glGenVertexArrays __glewGenVertexArrays
+#define glBindVertexArray __glewBindVertexArray
+#define glDeleteVertexArrays __glewDeleteVertexArrays
+#define glCreateShader __glewCreateShader
+#define glDeleteShader __glewDeleteShader
+#define glShaderSource __glewShaderSource
+#define glCompileShader __glewCompileShader
+#define glGetShaderiv __glewGetShaderiv
+#define glGetShaderInfoLog __glewGetShaderInfoLog
+#define glCreateProgram __glewCreateProgram
+#define glDeleteProgram __glewDeleteProgram
+#define glAttachShader __glewAttachShader
+#define glDetachShader __glewDetachShader
+#define glLinkProgram __glewLinkProgram
+#define glGetProgramiv __glewGetProgramiv
+#define glGetProgramInfoLog __glewGetProgramInfoLog
+#define glUseProgram __glewUseProgram
+#define glGetAttribLocation __glewGetAttribLocation
+#define glGetUniformLocation __glewGetUniformLocation
+#define glVertexAttribPointer __glewVertexAttribPointer
+#define glEnableVertexAttribArray __glewEnableVertexAttribArray
+#define glDisableVertexAttribArray __glewDisableVertexAttribArray
+#define glUniformMatrix4fv __glewUniformMatrix4fv
+#define glUniform1f __glewUniform1f
+#define glUniform2f __glewUniform2f
+#define glUniform1i __glewUniform1i
+#define glActiveTexture __glewActiveTexture
+#define glVertexAttrib4fv __glewVertexAttrib4fv
+#define glVertexAttribDivisor __glewVertexAttribDivisor
+#define glBindAttribLocation __glewBindAttribLocation
+#define glDrawElementsInstanced __glewDrawElementsInstanced
+
+#endif
+
@@ -0,0 +1,85 @@
+#ifndef MUTINY_ENGINE_INTERNAL_OBJECTLIST_H
+#define MUTINY_ENGINE_INTERNAL_OBJECTLIST_H
+
+#include "../Object.h"
+#include "../ref.h"
+#include "platform.h"
+
+#include <vector>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+class ObjectListBase
+{
+public:
+  virtual ~ObjectListBase() { }
+
+  virtual void add(Object* object) = 0;
+  virtual void remove(Object* object) = 0;
+
+};
+
+// Live list of every object in the scene that is a T. It is kept up to date
+// as GameObjects and Components come and go so that queries can copy it
+// rather than searching the scene. Removal swaps the last object into the
+// freed slot so the order of the list is not kept.
+template <class T>
+class ObjectList : public ObjectListBase
+{
+public:
+  std::vector<ref<T> > objects;
+  std::vector<Object*> keys;
+  unordered<Object*, size_t> slots;
+
+  virtual void add(Object* object)
+  {
+    T* t = dynamic_cast<T*>(object);
+
+    if(t != NULL)
+    {
+      slots[object] = objects.size();
+      objects.push_back(t);
+      keys.push_back(object);
+    }
+  }
+
+  virtual void remove(Object* object)
+  {
+    typename unordered<Object*, size_t>::iterator it = slots.find(object);
+
+    if(it == slots.end())
+    {
+      return;
+    }
+
+    size_t slot = it->second;
+    slots.erase(it);
+
+    if(slot != objects.size() - 1)
+    {
+      objects.at(slot) = objects.back();
+      keys.at(slot) = keys.back();
+      slots[keys.at(slot)] = slot;
+    }
+
+    objects.pop_back();
+    keys.pop_back();
+  }
+
+};
+
+}
+
+}
+
+}
+
+#endif
+
@@ -0,0 +1,15 @@
+#ifndef MUTINY_ENGINE_INTERNAL_OPENGL_H
+#define MUTINY_ENGINE_INTERNAL_OPENGL_H
+
+#include "platform.h"
+
+// Headless builds take their GL declarations from NullGl.h so that they do
+// not need the GLEW or GL development headers.
+#ifdef USE_HEADLESS
+  #include "NullGl.h"
+#else
+  #include <GL/glew.h>
+#endif
+
+#endif
+
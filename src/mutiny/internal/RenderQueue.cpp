@@ -0,0 +1,190 @@
+#include "RenderQueue.h"
+#include "../Application.h"
+#include "../Material.h"
+#include "../Shader.h"
+#include "../Texture.h"
+#include "../Mesh.h"
+#include "../Graphics.h"
+
+#include <cstring>
+
+#include <algorithm>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+struct PacketCompare
+{
+  std::vector<RenderPacket>* packets;
+
+  bool operator()(int a, int b)
+  {
+    RenderPacket& pa = packets->at(a);
+    RenderPacket& pb = packets->at(b);
+
+    if(pa.queue != pb.queue) return pa.queue < pb.queue;
+
+    // Transparent geometry has to blend over whatever is behind it so
+    // distance wins over state, furthest first.
+    if(pa.queue >= Material::TRANSPARENT_QUEUE && pa.depth != pb.depth)
+    {
+      return pa.depth > pb.depth;
+    }
+
+    if(pa.shader != pb.shader) return pa.shader < pb.shader;
+
+    // Separate materials may still be identical and drawn as one instanced
+    // run so for instancing shaders the mesh is sorted on first
+    if(pa.instanced == true)
+    {
+      if(pa.pass != pb.pass) return pa.pass < pb.pass;
+      if(pa.texture != pb.texture) return pa.texture < pb.texture;
+      if(pa.mesh != pb.mesh) return pa.mesh < pb.mesh;
+      if(pa.submesh != pb.submesh) return pa.submesh < pb.submesh;
+    }
+
+    if(pa.material != pb.material) return pa.material < pb.material;
+    if(pa.pass != pb.pass) return pa.pass < pb.pass;
+    if(pa.texture != pb.texture) return pa.texture < pb.texture;
+    if(pa.mesh != pb.mesh) return pa.mesh < pb.mesh;
+    if(pa.submesh != pb.submesh) return pa.submesh < pb.submesh;
+
+    // Within a batch opaque draws go nearest first to make use of early
+    // depth rejection
+    return pa.depth < pb.depth;
+  }
+};
+
+shared<RenderQueue> RenderQueue::create()
+{
+  shared<RenderQueue> rtn;
+
+  rtn.reset(new RenderQueue());
+
+  return rtn;
+}
+
+RenderQueue::RenderQueue()
+{
+
+}
+
+void RenderQueue::submit(Material* material, int pass, Mesh* mesh, int submesh,
+  float depth, Matrix4x4& modelMatrix, Matrix4x4& normalMatrix)
+{
+  RenderPacket packet;
+  packet.queue = material->getRenderQueue();
+  packet.shader = material->getShader().get();
+  packet.material = material;
+  packet.pass = pass;
+  packet.texture = material->getMainTexture().try_get();
+  packet.mesh = mesh;
+  packet.submesh = submesh;
+  packet.instanced = material->instanceModelId != -1;
+  packet.depth = depth;
+  packet.modelMatrix = modelMatrix;
+  packet.normalMatrix = normalMatrix;
+
+  packets.push_back(packet);
+}
+
+void RenderQueue::flush(Matrix4x4& projectionMatrix, Matrix4x4& viewMatrix)
+{
+  order.clear();
+
+  for(size_t i = 0; i < packets.size(); i++)
+  {
+    order.push_back(i);
+  }
+
+  PacketCompare compare;
+  compare.packets = &packets;
+  std::sort(order.begin(), order.end(), compare);
+
+  static int projectionId = Shader::propertyToId("in_Projection");
+  static int viewId = Shader::propertyToId("in_View");
+  static int normalMatrixId = Shader::propertyToId("in_NormalMatrix");
+
+  Material* lastMaterial = NULL;
+  int lastPass = -1;
+
+  for(size_t i = 0; i < order.size();)
+  {
+    RenderPacket& packet = packets.at(order.at(i));
+    Material* material = packet.material;
+
+    // Uniforms and textures owned by the material are only uploaded when the
+    // material or pass changes, everything per object is set directly.
+    bool passChanged = material != lastMaterial || packet.pass != lastPass;
+
+    if(passChanged == true)
+    {
+      material->setMatrix(projectionId, projectionMatrix);
+      material->setMatrix(viewId, viewMatrix);
+      material->setMatrix(normalMatrixId, packet.normalMatrix);
+      material->setPass(packet.pass, material);
+      lastMaterial = material;
+      lastPass = packet.pass;
+    }
+
+    if(material->instanceModelId != -1)
+    {
+      size_t end = i;
+      instances.clear();
+
+      while(end < order.size())
+      {
+        RenderPacket& next = packets.at(order.at(end));
+
+        if(next.pass != packet.pass || next.mesh != packet.mesh ||
+          next.submesh != packet.submesh || material->matches(next.material) == false)
+        {
+          break;
+        }
+
+        // Laid out as Graphics expects, model matrix then normal matrix
+        size_t base = instances.size();
+        instances.resize(base + 32);
+        memcpy(&instances[base], next.modelMatrix.getValue(), 16 * sizeof(float));
+        memcpy(&instances[base + 16], next.normalMatrix.getValue(), 16 * sizeof(float));
+        end++;
+      }
+
+      Graphics::drawMeshInstances(packet.mesh, packet.submesh, &instances[0], end - i);
+      i = end;
+
+      continue;
+    }
+
+    if(passChanged == false)
+    {
+      packet.shader->setUniform(material->normalMatrixUniformId, GL_FLOAT_MAT4,
+        packet.normalMatrix.getValue(), NULL);
+    }
+
+    Graphics::drawMeshNow(packet.mesh, packet.modelMatrix, packet.submesh);
+    i++;
+  }
+
+  clear();
+}
+
+void RenderQueue::clear()
+{
+  packets.clear();
+  order.clear();
+  instances.clear();
+}
+
+}
+
+}
+
+}
+
@@ -0,0 +1,73 @@
+#ifndef MUTINY_ENGINE_INTERNAL_RENDERQUEUE_H
+#define MUTINY_ENGINE_INTERNAL_RENDERQUEUE_H
+
+#include "../Matrix4x4.h"
+#include "../ref.h"
+
+#include <vector>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+class Material;
+class Shader;
+class Texture;
+class Mesh;
+
+namespace internal
+{
+
+class RenderPacket
+{
+public:
+  int queue;
+  Shader* shader;
+  Material* material;
+  int pass;
+  Texture* texture;
+  Mesh* mesh;
+  int submesh;
+  bool instanced;
+  float depth;
+  Matrix4x4 modelMatrix;
+  Matrix4x4 normalMatrix;
+
+};
+
+// Draws submitted by renderers while a camera renders. Rather than drawing
+// in scene order the packets are sorted once everything has been submitted
+// so that draws sharing a shader, material and mesh end up adjacent and
+// only the state that actually changes between them is sent to GL. Runs of
+// the same mesh with identical materials whose shader takes per instance
+// matrices are collapsed into a single instanced draw.
+class RenderQueue
+{
+public:
+  static shared<RenderQueue> create();
+
+  void submit(Material* material, int pass, Mesh* mesh, int submesh,
+    float depth, Matrix4x4& modelMatrix, Matrix4x4& normalMatrix);
+
+  void flush(Matrix4x4& projectionMatrix, Matrix4x4& viewMatrix);
+  void clear();
+
+private:
+  std::vector<RenderPacket> packets;
+  std::vector<int> order;
+  std::vector<float> instances;
+
+  RenderQueue();
+
+};
+
+}
+
+}
+
+}
+
+#endif
+
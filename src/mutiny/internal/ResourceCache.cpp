@@ -0,0 +1,180 @@
+#include "ResourceCache.h"
+#include "../Object.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+int EvictableResource::frame = 0;
+
+static void hashBytes(unsigned int& hash, const void* data, size_t size)
+{
+  const unsigned char* bytes = (const unsigned char*)data;
+
+  for(size_t i = 0; i < size; i++)
+  {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+}
+
+shared<ResourceCache> ResourceCache::create()
+{
+  shared<ResourceCache> rtn;
+
+  rtn.reset(new ResourceCache());
+
+  return rtn;
+}
+
+ResourceCache::ResourceCache()
+{
+  budget = 0;
+}
+
+unsigned int ResourceCache::hashKey(int type, std::string& path)
+{
+  unsigned int hash = 2166136261u;
+
+  hashBytes(hash, &type, sizeof(type));
+  hashBytes(hash, path.c_str(), path.length());
+
+  return hash;
+}
+
+Object* ResourceCache::find(int type, std::string& path)
+{
+  typedef unordered_multi<unsigned int, ResourceCacheEntry>::iterator Iterator;
+
+  std::pair<Iterator, Iterator> range = entries.equal_range(hashKey(type, path));
+
+  for(Iterator it = range.first; it != range.second; it++)
+  {
+    if(it->second.type == type && it->second.path == path)
+    {
+      return it->second.object.get();
+    }
+  }
+
+  return NULL;
+}
+
+void ResourceCache::add(int type, std::string& path, shared<Object> object)
+{
+  ResourceCacheEntry entry;
+  entry.type = type;
+  entry.path = path;
+  entry.object = object;
+  entry.resource = dynamic_cast<EvictableResource*>(object.get());
+
+  entries.insert(std::make_pair(hashKey(type, path), entry));
+}
+
+void ResourceCache::sweepDestroyOnLoad()
+{
+  typedef unordered_multi<unsigned int, ResourceCacheEntry>::iterator Iterator;
+
+  for(Iterator it = entries.begin(); it != entries.end();)
+  {
+    if(it->second.object->destroyOnLoad == true)
+    {
+      entries.erase(it++);
+    }
+    else
+    {
+      it++;
+    }
+  }
+}
+
+void ResourceCache::setBudget(size_t budget)
+{
+  this->budget = budget;
+}
+
+size_t ResourceCache::getBudget()
+{
+  return budget;
+}
+
+size_t ResourceCache::getUsage()
+{
+  typedef unordered_multi<unsigned int, ResourceCacheEntry>::iterator Iterator;
+
+  size_t rtn = 0;
+
+  for(Iterator it = entries.begin(); it != entries.end(); it++)
+  {
+    if(it->second.resource != NULL)
+    {
+      rtn += it->second.resource->getResidentSize();
+    }
+  }
+
+  return rtn;
+}
+
+// Called once a frame, after the frame has been drawn. A budget of zero
+// leaves everything resident.
+void ResourceCache::trim()
+{
+  typedef unordered_multi<unsigned int, ResourceCacheEntry>::iterator Iterator;
+
+  int frame = EvictableResource::frame;
+
+  EvictableResource::frame++;
+
+  if(budget == 0)
+  {
+    return;
+  }
+
+  std::vector<std::pair<int, EvictableResource*> > unused;
+  size_t usage = 0;
+
+  for(Iterator it = entries.begin(); it != entries.end(); it++)
+  {
+    EvictableResource* resource = it->second.resource;
+
+    if(resource == NULL)
+    {
+      continue;
+    }
+
+    size_t size = resource->getResidentSize();
+    usage += size;
+
+    if(resource->lastUsed < frame && resource->canEvict() == true)
+    {
+      unused.push_back(std::make_pair(resource->lastUsed, resource));
+    }
+  }
+
+  if(usage <= budget)
+  {
+    return;
+  }
+
+  std::sort(unused.begin(), unused.end());
+
+  for(size_t i = 0; i < unused.size() && usage > budget; i++)
+  {
+    usage -= unused.at(i).second->getResidentSize();
+    unused.at(i).second->evict();
+  }
+}
+
+}
+
+}
+
+}
+
@@ -0,0 +1,106 @@
+#ifndef MUTINY_ENGINE_INTERNAL_RESOURCECACHE_H
+#define MUTINY_ENGINE_INTERNAL_RESOURCECACHE_H
+
+#include "../ref.h"
+#include "platform.h"
+
+#include <string>
+#include <cstddef>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+class Object;
+
+namespace internal
+{
+
+// A resource whose data can be released while nothing draws with it and
+// read back from its file the next time something does. Anything that
+// uses the data marks it with the current frame so the least recently
+// used are released first.
+class EvictableResource
+{
+public:
+  static int frame;
+
+  int lastUsed;
+
+  EvictableResource()
+  {
+    lastUsed = frame;
+  }
+
+  virtual ~EvictableResource()
+  {
+
+  }
+
+  void markUsed()
+  {
+    lastUsed = frame;
+  }
+
+  // CPU and GPU bytes currently held
+  virtual size_t getResidentSize() = 0;
+
+  // Whether the data can be released and later restored as it is now
+  virtual bool canEvict() = 0;
+  virtual void evict() = 0;
+
+};
+
+class ResourceCacheEntry
+{
+public:
+  int type;
+  std::string path;
+  shared<Object> object;
+  EvictableResource* resource;
+
+};
+
+// Everything loaded through Resources, keyed by TypeId and the path it was
+// requested with. Lookups hash the path in place rather than building a
+// key string so finding a resource that is already loaded costs a hash
+// and a short walk of the matching entries.
+//
+// When a memory budget is set the data of resources not used in the last
+// frame is evicted, least recently used first, until the total is back
+// under it. The objects themselves stay cached so references to them
+// remain valid.
+class ResourceCache
+{
+public:
+  static shared<ResourceCache> create();
+
+  Object* find(int type, std::string& path);
+  void add(int type, std::string& path, shared<Object> object);
+  void sweepDestroyOnLoad();
+
+  void setBudget(size_t budget);
+  size_t getBudget();
+  size_t getUsage();
+  void trim();
+
+private:
+  static unsigned int hashKey(int type, std::string& path);
+
+  unordered_multi<unsigned int, ResourceCacheEntry> entries;
+  size_t budget;
+
+  ResourceCache();
+
+};
+
+}
+
+}
+
+}
+
+#endif
+
@@ -0,0 +1,121 @@
+#include "ResourceIndex.h"
+#include "CWrapper.h"
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+shared<ResourceIndex> ResourceIndex::create(std::string dataPath, std::string engineDataPath)
+{
+  shared<ResourceIndex> rtn;
+
+  rtn.reset(new ResourceIndex());
+  rtn->roots.push_back(dataPath);
+
+  // Both are the same directory on some platforms
+  if(engineDataPath != dataPath)
+  {
+    rtn->roots.push_back(engineDataPath);
+  }
+
+  return rtn;
+}
+
+ResourceIndex::ResourceIndex()
+{
+  scanned = false;
+}
+
+void ResourceIndex::refresh()
+{
+  names.clear();
+
+  for(size_t i = 0; i < roots.size(); i++)
+  {
+    scan(i, "");
+  }
+
+  scanned = true;
+}
+
+void ResourceIndex::scan(int root, std::string folder)
+{
+  std::vector<std::string> files;
+  std::vector<std::string> directories;
+  std::string prefix = folder == "" ? "" : folder + "/";
+
+  if(Directory::list(roots.at(root) + "/" + folder, files, directories) == false)
+  {
+    return;
+  }
+
+  // Loaders such as Animation are given the whole filename rather than
+  // adding an extension of their own so both forms are indexed
+  for(size_t i = 0; i < files.size(); i++)
+  {
+    size_t dot = files.at(i).find_last_of('.');
+
+    names[prefix + files.at(i)] |= 1 << root;
+
+    if(dot != std::string::npos && dot > 0)
+    {
+      names[prefix + files.at(i).substr(0, dot)] |= 1 << root;
+    }
+  }
+
+  for(size_t i = 0; i < directories.size(); i++)
+  {
+    scan(root, prefix + directories.at(i));
+  }
+}
+
+// Fills candidates with the files worth trying for path in the order
+// Resources::load has always searched. A path under neither root can
+// still be absolute or relative to the working directory.
+void ResourceIndex::resolve(std::string& path, std::vector<std::string>& candidates)
+{
+  if(scanned == false)
+  {
+    refresh();
+  }
+
+  // Names the index cannot hold are probed under every root as before
+  if(path.find("./") != std::string::npos || path.find("//") != std::string::npos ||
+    path.find('\\') != std::string::npos)
+  {
+    for(size_t i = 0; i < roots.size(); i++)
+    {
+      candidates.push_back(roots.at(i) + "/" + path);
+    }
+
+    candidates.push_back(path);
+
+    return;
+  }
+
+  // A name missing from the index may be a file added since the scan or
+  // one a loader finds by a name of its own, so every root is still tried
+  std::map<std::string, int>::iterator it = names.find(path);
+
+  for(size_t i = 0; i < roots.size(); i++)
+  {
+    if(it == names.end() || (it->second & (1 << i)) != 0)
+    {
+      candidates.push_back(roots.at(i) + "/" + path);
+    }
+  }
+
+  candidates.push_back(path);
+}
+
+}
+
+}
+
+}
+
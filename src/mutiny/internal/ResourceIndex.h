@@ -0,0 +1,52 @@
+#ifndef MUTINY_ENGINE_INTERNAL_RESOURCEINDEX_H
+#define MUTINY_ENGINE_INTERNAL_RESOURCEINDEX_H
+
+#include "../ref.h"
+
+#include <string>
+#include <vector>
+#include <map>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+// Every file under the game and engine data directories, keyed by the names
+// Resources::load may be given for it, which are its path relative to the
+// data directory with and without the extension. Each name maps to the
+// roots holding such a file so a load only opens files that are known to
+// exist rather than trying each root in turn and catching the failures. The scan is
+// made on first use and again on refresh, for files added or removed
+// while running.
+class ResourceIndex
+{
+public:
+  static shared<ResourceIndex> create(std::string dataPath, std::string engineDataPath);
+
+  void refresh();
+  void resolve(std::string& path, std::vector<std::string>& candidates);
+
+private:
+  std::vector<std::string> roots;
+  std::map<std::string, int> names;
+  bool scanned;
+
+  ResourceIndex();
+
+  void scan(int root, std::string folder);
+
+};
+
+}
+
+}
+
+}
+
+#endif
+
@@ -0,0 +1,177 @@
+#include "TextLayoutCache.h"
+#include "../Font.h"
+#include "../CharacterInfo.h"
+#include "../TextAnchor.h"
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+static void hashBytes(unsigned int& hash, const void* data, size_t size)
+{
+  const unsigned char* bytes = (const unsigned char*)data;
+
+  for(size_t i = 0; i < size; i++)
+  {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+}
+
+shared<TextLayoutCache> TextLayoutCache::create()
+{
+  shared<TextLayoutCache> rtn;
+
+  rtn.reset(new TextLayoutCache());
+
+  return rtn;
+}
+
+TextLayoutCache::TextLayoutCache()
+{
+  frame = 0;
+}
+
+unsigned int TextLayoutCache::hashKey(Font* font, std::string& text, Rect& rect, int alignment)
+{
+  unsigned int hash = 2166136261u;
+  float values[] = { rect.x, rect.y, rect.width, rect.height };
+
+  hashBytes(hash, &font, sizeof(font));
+  hashBytes(hash, text.c_str(), text.length());
+  hashBytes(hash, values, sizeof(values));
+  hashBytes(hash, &alignment, sizeof(alignment));
+
+  return hash;
+}
+
+TextLayout* TextLayoutCache::getLayout(ref<Font> font, std::string& text, Rect& rect, int alignment)
+{
+  typedef std::multimap<unsigned int, shared<TextLayout> >::iterator Iterator;
+
+  unsigned int hash = hashKey(font.get(), text, rect, alignment);
+  std::pair<Iterator, Iterator> range = layouts.equal_range(hash);
+
+  for(Iterator it = range.first; it != range.second; it++)
+  {
+    TextLayout* layout = it->second.get();
+
+    if(layout->font.expired() || layout->font.get() != font.get() ||
+      layout->alignment != alignment || layout->rect.equals(rect) == false ||
+      layout->text != text)
+    {
+      continue;
+    }
+
+    layout->lastUsed = frame;
+
+    return layout;
+  }
+
+  shared<TextLayout> layout(new TextLayout());
+  layout->font = font;
+  layout->text = text;
+  layout->rect = rect;
+  layout->alignment = alignment;
+  layout->hash = hash;
+  layout->lastUsed = frame;
+  build(*layout);
+  layouts.insert(std::make_pair(hash, layout));
+
+  return layout.get();
+}
+
+void TextLayoutCache::build(TextLayout& layout)
+{
+  Font* font = layout.font.get();
+  Rect& rect = layout.rect;
+  std::string& text = layout.text;
+  float padding = 0;
+  float left = 0;
+
+  if(layout.alignment == TextAnchor::MiddleLeft)
+  {
+    padding = 10;
+    left = rect.x + padding;
+  }
+  else
+  {
+    float width = 0;
+
+    for(size_t i = 0; i < text.length(); i++)
+    {
+      CharacterInfo* info = font->getGlyph(text[i]);
+
+      if(info != NULL)
+      {
+        width += info->advance;
+      }
+    }
+
+    left = rect.x + (rect.width / 2) - (width / 2);
+  }
+
+  float pen = 0;
+
+  for(size_t i = 0; i < text.length(); i++)
+  {
+    CharacterInfo* info = font->getGlyph(text[i]);
+
+    if(info == NULL)
+    {
+      continue;
+    }
+
+    if(pen + padding > rect.width - padding)
+    {
+      break;
+    }
+
+    layout.positions.push_back(Rect(left + pen,
+      rect.y + (rect.height / 2) - (info->vert.height / 2),
+      info->vert.width, info->vert.height));
+
+    layout.uvs.push_back(info->uv);
+    pen += info->advance;
+  }
+}
+
+void TextLayoutCache::sweepUnused()
+{
+  typedef std::multimap<unsigned int, shared<TextLayout> >::iterator Iterator;
+
+  frame++;
+
+  // Labels come and go far less often than frames pass so only look for
+  // stale layouts every so often
+  if(frame % MAX_UNUSED_FRAMES != 0)
+  {
+    return;
+  }
+
+  for(Iterator it = layouts.begin(); it != layouts.end();)
+  {
+    TextLayout* layout = it->second.get();
+
+    if(layout->font.expired() || frame - layout->lastUsed >= MAX_UNUSED_FRAMES)
+    {
+      layouts.erase(it++);
+    }
+    else
+    {
+      it++;
+    }
+  }
+}
+
+}
+
+}
+
+}
+
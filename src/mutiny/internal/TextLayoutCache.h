@@ -0,0 +1,69 @@
+#ifndef MUTINY_ENGINE_INTERNAL_TEXTLAYOUTCACHE_H
+#define MUTINY_ENGINE_INTERNAL_TEXTLAYOUTCACHE_H
+
+#include "../Rect.h"
+#include "../ref.h"
+
+#include <vector>
+#include <string>
+#include <map>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+class Font;
+
+namespace internal
+{
+
+class TextLayout
+{
+public:
+  ref<Font> font;
+  std::string text;
+  Rect rect;
+  int alignment;
+  unsigned int hash;
+  int lastUsed;
+
+  std::vector<Rect> positions;
+  std::vector<Rect> uvs;
+
+};
+
+// Glyph quads for strings the Gui has already laid out. Most labels are
+// drawn with the same text in the same place every frame so the quads are
+// kept, keyed by font, text, rect and alignment, and handed straight back
+// until the label stops being drawn.
+class TextLayoutCache
+{
+public:
+  static shared<TextLayoutCache> create();
+
+  TextLayout* getLayout(ref<Font> font, std::string& text, Rect& rect, int alignment);
+  void sweepUnused();
+
+private:
+  static const int MAX_UNUSED_FRAMES = 10;
+
+  static unsigned int hashKey(Font* font, std::string& text, Rect& rect, int alignment);
+  static void build(TextLayout& layout);
+
+  std::multimap<unsigned int, shared<TextLayout> > layouts;
+  int frame;
+
+  TextLayoutCache();
+
+};
+
+}
+
+}
+
+}
+
+#endif
+
@@ -0,0 +1,145 @@
+#include "TextureAtlas.h"
+#include "../Application.h"
+#include "../Texture2d.h"
+#include "../Rect.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+ref<Texture2d> TextureAtlas::find(std::string path)
+{
+  std::vector<shared<TextureAtlas> >& atlases = Application::context->atlases;
+  std::string roots[] = { Application::getDataPath(), Application::getEngineDataPath() };
+
+  for(size_t r = 0; r < 2; r++)
+  {
+    std::string prefix = roots[r] + "/";
+
+    if(path.compare(0, prefix.length(), prefix) != 0)
+    {
+      continue;
+    }
+
+    shared<TextureAtlas> atlas;
+
+    for(size_t i = 0; i < atlases.size(); i++)
+    {
+      if(atlases.at(i)->root == roots[r])
+      {
+        atlas = atlases.at(i);
+        break;
+      }
+    }
+
+    // Roots without an atlas are remembered too so the index is only
+    // looked for once
+    if(atlas.get() == NULL)
+    {
+      atlas = load(roots[r]);
+      atlases.push_back(atlas);
+    }
+
+    std::map<std::string, TextureAtlasEntry>::iterator it =
+      atlas->entries.find(path.substr(prefix.length()));
+
+    if(it == atlas->entries.end())
+    {
+      continue;
+    }
+
+    TextureAtlasEntry& entry = it->second;
+    TextureAtlasPage& page = atlas->pages.at(entry.page);
+    shared<Texture2d> pageTexture = atlas->getPage(entry.page);
+
+    if(pageTexture.get() == NULL)
+    {
+      return NULL;
+    }
+
+    Texture2d* rtn = new Texture2d(entry.width, entry.height);
+    rtn->atlas = pageTexture;
+    rtn->nativeTexture = pageTexture->nativeTexture;
+
+    rtn->uvRect = Rect((float)entry.x / (float)page.width,
+      (float)entry.y / (float)page.height,
+      (float)entry.width / (float)page.width,
+      (float)entry.height / (float)page.height);
+
+    return rtn;
+  }
+
+  return NULL;
+}
+
+shared<TextureAtlas> TextureAtlas::load(std::string root)
+{
+  shared<TextureAtlas> rtn(new TextureAtlas());
+  rtn->root = root;
+
+  std::ifstream file((root + "/_atlas/atlas.txt").c_str());
+  std::string line;
+
+  while(std::getline(file, line))
+  {
+    std::stringstream ss(line);
+    std::string type;
+    ss >> type;
+
+    if(type == "page")
+    {
+      TextureAtlasPage page;
+      ss >> page.width >> page.height >> page.name;
+      rtn->pages.push_back(page);
+    }
+    else if(type == "image" && rtn->pages.size() > 0)
+    {
+      TextureAtlasEntry entry;
+      std::string name;
+      entry.page = rtn->pages.size() - 1;
+      ss >> entry.x >> entry.y >> entry.width >> entry.height;
+      std::getline(ss >> std::ws, name);
+      rtn->entries[name] = entry;
+    }
+  }
+
+  return rtn;
+}
+
+shared<Texture2d> TextureAtlas::getPage(int index)
+{
+  TextureAtlasPage& page = pages.at(index);
+  shared<Texture2d> rtn = page.texture.lock();
+
+  if(rtn.get() == NULL)
+  {
+    // Page paths are not in the table so this loads the image itself
+    try
+    {
+      rtn.reset(Texture2d::load(root + "/_atlas/" + page.name).try_get());
+    }
+    catch(std::exception& e)
+    {
+      return shared<Texture2d>();
+    }
+
+    page.texture = rtn;
+  }
+
+  return rtn;
+}
+
+}
+
+}
+
+}
+
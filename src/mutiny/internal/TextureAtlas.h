@@ -0,0 +1,69 @@
+#ifndef MUTINY_ENGINE_INTERNAL_TEXTUREATLAS_H
+#define MUTINY_ENGINE_INTERNAL_TEXTUREATLAS_H
+
+#include "../ref.h"
+
+#include <string>
+#include <vector>
+#include <map>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+class Texture2d;
+
+namespace internal
+{
+
+class TextureAtlasPage
+{
+public:
+  std::string name;
+  int width;
+  int height;
+  weak<Texture2d> texture;
+
+};
+
+class TextureAtlasEntry
+{
+public:
+  int page;
+  int x;
+  int y;
+  int width;
+  int height;
+
+};
+
+// Lookup table written by mutt's atlas step for one data directory. Images
+// from directories marked for atlasing are resolved to a view onto the page
+// they were packed into so Gui draws using them can share a batch. Pages
+// are only held while a view of them is alive.
+class TextureAtlas
+{
+public:
+  static ref<Texture2d> find(std::string path);
+
+private:
+  static shared<TextureAtlas> load(std::string root);
+
+  std::string root;
+  std::vector<TextureAtlasPage> pages;
+  std::map<std::string, TextureAtlasEntry> entries;
+
+  shared<Texture2d> getPage(int index);
+
+};
+
+}
+
+}
+
+}
+
+#endif
+
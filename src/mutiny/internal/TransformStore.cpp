@@ -0,0 +1,255 @@
+#include "TransformStore.h"
+#include "../Transform.h"
+
+#include <algorithm>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+struct DepthCompare
+{
+  std::vector<int>* depths;
+
+  bool operator()(int a, int b)
+  {
+    return depths->at(a) < depths->at(b);
+  }
+};
+
+shared<TransformStore> TransformStore::create()
+{
+  shared<TransformStore> rtn;
+
+  rtn.reset(new TransformStore());
+
+  return rtn;
+}
+
+TransformStore::TransformStore()
+{
+  sorted = true;
+}
+
+int TransformStore::add(Transform* owner)
+{
+  int index = 0;
+
+  if(freeSlots.size() > 0)
+  {
+    index = freeSlots.back();
+    freeSlots.pop_back();
+  }
+  else
+  {
+    index = owners.size();
+    localPositions.push_back(Vector3());
+    localRotations.push_back(Vector3());
+    localScales.push_back(Vector3());
+    parents.push_back(-1);
+    hierarchyMatrices.push_back(Matrix4x4());
+    localToWorldMatrices.push_back(Matrix4x4());
+    worldToLocalMatrices.push_back(Matrix4x4());
+    positions.push_back(Vector3());
+    rotations.push_back(Vector3());
+    dirty.push_back(true);
+    inverseDirty.push_back(true);
+    owners.push_back(NULL);
+  }
+
+  localPositions.at(index) = Vector3();
+  localRotations.at(index) = Vector3();
+  localScales.at(index) = Vector3(1, 1, 1);
+  parents.at(index) = -1;
+  dirty.at(index) = true;
+  inverseDirty.at(index) = true;
+  owners.at(index) = owner;
+
+  return index;
+}
+
+void TransformStore::remove(int index)
+{
+  // Children have already been detached by the owning Transform
+  owners.at(index) = NULL;
+  parents.at(index) = -1;
+  freeSlots.push_back(index);
+}
+
+void TransformStore::setParent(int index, int parent)
+{
+  parents.at(index) = parent;
+
+  if(parent > index)
+  {
+    sorted = false;
+  }
+}
+
+void TransformStore::compute(int index)
+{
+  Matrix4x4 localMatrix = Matrix4x4::getTrs(localPositions[index],
+    localRotations[index], Vector3(1, 1, 1));
+
+  int parent = parents[index];
+
+  if(parent != -1)
+  {
+    hierarchyMatrices[index] = hierarchyMatrices[parent] * localMatrix;
+    rotations[index] = rotations[parent] + localRotations[index];
+  }
+  else
+  {
+    hierarchyMatrices[index] = localMatrix;
+    rotations[index] = localRotations[index];
+  }
+
+  positions[index] = hierarchyMatrices[index] * Vector3();
+
+  // Scale is not applied when rendering so it is left out here too
+  localToWorldMatrices[index] = Matrix4x4::getTrs(positions[index],
+    rotations[index], Vector3(1, 1, 1));
+
+  dirty[index] = false;
+}
+
+void TransformStore::update(int index)
+{
+  if(dirty.at(index) == false)
+  {
+    return;
+  }
+
+  if(parents.at(index) != -1)
+  {
+    update(parents.at(index));
+  }
+
+  compute(index);
+}
+
+void TransformStore::updateInverse(int index)
+{
+  update(index);
+
+  if(inverseDirty.at(index) == true)
+  {
+    worldToLocalMatrices.at(index) = localToWorldMatrices.at(index).inverse();
+    inverseDirty.at(index) = false;
+  }
+}
+
+void TransformStore::updateAll()
+{
+  if(sorted == false)
+  {
+    sort();
+  }
+
+  size_t count = owners.size();
+
+  // Parents come first so by the time a child is reached its parent is
+  // already up to date.
+  for(size_t i = 0; i < count; i++)
+  {
+    if(dirty[i] == true && owners[i] != NULL)
+    {
+      compute(i);
+    }
+  }
+}
+
+int TransformStore::getDepth(int index, std::vector<int>& depths)
+{
+  if(depths.at(index) != -1)
+  {
+    return depths.at(index);
+  }
+
+  int depth = 0;
+
+  if(parents.at(index) != -1)
+  {
+    depth = getDepth(parents.at(index), depths) + 1;
+  }
+
+  depths.at(index) = depth;
+
+  return depth;
+}
+
+void TransformStore::sort()
+{
+  std::vector<int> depths(owners.size(), -1);
+  std::vector<int> order;
+
+  for(size_t i = 0; i < owners.size(); i++)
+  {
+    if(owners.at(i) != NULL)
+    {
+      getDepth(i, depths);
+      order.push_back(i);
+    }
+  }
+
+  DepthCompare compare;
+  compare.depths = &depths;
+  std::stable_sort(order.begin(), order.end(), compare);
+
+  // Free slots are dropped so the store is also compacted
+  std::vector<int> remap(owners.size(), -1);
+
+  for(size_t i = 0; i < order.size(); i++)
+  {
+    remap.at(order.at(i)) = i;
+  }
+
+  TransformStore sortedStore;
+
+  for(size_t i = 0; i < order.size(); i++)
+  {
+    int from = order.at(i);
+    int parent = parents.at(from);
+
+    sortedStore.localPositions.push_back(localPositions.at(from));
+    sortedStore.localRotations.push_back(localRotations.at(from));
+    sortedStore.localScales.push_back(localScales.at(from));
+    sortedStore.parents.push_back(parent == -1 ? -1 : remap.at(parent));
+    sortedStore.hierarchyMatrices.push_back(hierarchyMatrices.at(from));
+    sortedStore.localToWorldMatrices.push_back(localToWorldMatrices.at(from));
+    sortedStore.worldToLocalMatrices.push_back(worldToLocalMatrices.at(from));
+    sortedStore.positions.push_back(positions.at(from));
+    sortedStore.rotations.push_back(rotations.at(from));
+    sortedStore.dirty.push_back(dirty.at(from));
+    sortedStore.inverseDirty.push_back(inverseDirty.at(from));
+    sortedStore.owners.push_back(owners.at(from));
+    owners.at(from)->index = i;
+  }
+
+  localPositions.swap(sortedStore.localPositions);
+  localRotations.swap(sortedStore.localRotations);
+  localScales.swap(sortedStore.localScales);
+  parents.swap(sortedStore.parents);
+  hierarchyMatrices.swap(sortedStore.hierarchyMatrices);
+  localToWorldMatrices.swap(sortedStore.localToWorldMatrices);
+  worldToLocalMatrices.swap(sortedStore.worldToLocalMatrices);
+  positions.swap(sortedStore.positions);
+  rotations.swap(sortedStore.rotations);
+  dirty.swap(sortedStore.dirty);
+  inverseDirty.swap(sortedStore.inverseDirty);
+  owners.swap(sortedStore.owners);
+  freeSlots.clear();
+  sorted = true;
+}
+
+}
+
+}
+
+}
+
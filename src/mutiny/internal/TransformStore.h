@@ -0,0 +1,69 @@
+#ifndef MUTINY_ENGINE_INTERNAL_TRANSFORMSTORE_H
+#define MUTINY_ENGINE_INTERNAL_TRANSFORMSTORE_H
+
+#include "../Vector3.h"
+#include "../Matrix4x4.h"
+#include "../ref.h"
+
+#include <vector>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+class Transform;
+
+namespace internal
+{
+
+// Contiguous storage for every Transform in the scene. A Transform is only
+// a handle holding its slot index. Slots are kept ordered so that a parent
+// always comes before its children, which lets updateAll() refresh the
+// world matrices of the whole scene in a single linear pass.
+class TransformStore
+{
+public:
+  static shared<TransformStore> create();
+
+  std::vector<Vector3> localPositions;
+  std::vector<Vector3> localRotations;
+  std::vector<Vector3> localScales;
+  std::vector<int> parents;
+  std::vector<Matrix4x4> hierarchyMatrices;
+  std::vector<Matrix4x4> localToWorldMatrices;
+  std::vector<Matrix4x4> worldToLocalMatrices;
+  std::vector<Vector3> positions;
+  std::vector<Vector3> rotations;
+  std::vector<char> dirty;
+  std::vector<char> inverseDirty;
+  std::vector<Transform*> owners;
+
+  int add(Transform* owner);
+  void remove(int index);
+  void setParent(int index, int parent);
+  void update(int index);
+  void updateInverse(int index);
+  void updateAll();
+
+private:
+  std::vector<int> freeSlots;
+  bool sorted;
+
+  TransformStore();
+
+  void compute(int index);
+  void sort();
+  int getDepth(int index, std::vector<int>& depths);
+
+};
+
+}
+
+}
+
+}
+
+#endif
+
@@ -0,0 +1,26 @@
+#include "TypeId.h"
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+int TypeId::next()
+{
+  static int counter = 0;
+
+  counter++;
+
+  return counter - 1;
+}
+
+}
+
+}
+
+}
+
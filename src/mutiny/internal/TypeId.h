@@ -0,0 +1,38 @@
+#ifndef MUTINY_ENGINE_INTERNAL_TYPEID_H
+#define MUTINY_ENGINE_INTERNAL_TYPEID_H
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+class TypeId
+{
+public:
+  // Small dense integer per type, handed out on first use. Suitable for
+  // indexing vectors rather than relying on RTTI.
+  template <class T>
+  static int get()
+  {
+    static int id = next();
+
+    return id;
+  }
+
+private:
+  static int next();
+
+};
+
+}
+
+}
+
+}
+
+#endif
+
@@ -0,0 +1,83 @@
+#include "VertexCache.h"
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+bool VertexKey::operator<(const VertexKey& other) const
+{
+  for(int i = 0; i < 12; i++)
+  {
+    if(values[i] < other.values[i])
+    {
+      return true;
+    }
+    else if(values[i] > other.values[i])
+    {
+      return false;
+    }
+  }
+
+  return false;
+}
+
+int VertexCache::add(Vector3 position, Vector3 normal, Vector2 coord)
+{
+  return add(position, normal, coord, Color(), false);
+}
+
+int VertexCache::add(Vector3 position, Vector3 normal, Vector2 coord, Color color)
+{
+  return add(position, normal, coord, color, true);
+}
+
+int VertexCache::add(Vector3 position, Vector3 normal, Vector2 coord, Color color, bool hasColor)
+{
+  VertexKey key;
+
+  key.values[0] = position.x; key.values[1] = position.y; key.values[2] = position.z;
+  key.values[3] = normal.x; key.values[4] = normal.y; key.values[5] = normal.z;
+  key.values[6] = coord.x; key.values[7] = coord.y;
+  key.values[8] = color.r; key.values[9] = color.g; key.values[10] = color.b; key.values[11] = color.a;
+
+  std::map<VertexKey, int>::iterator it = indices.find(key);
+
+  if(it != indices.end())
+  {
+    return it->second;
+  }
+
+  int index = vertices.size();
+  indices[key] = index;
+  vertices.push_back(position);
+  normals.push_back(normal);
+  uv.push_back(coord);
+
+  if(hasColor == true)
+  {
+    colors.push_back(color);
+  }
+
+  return index;
+}
+
+void VertexCache::clear()
+{
+  vertices.clear();
+  normals.clear();
+  uv.clear();
+  colors.clear();
+  indices.clear();
+}
+
+}
+
+}
+
+}
+
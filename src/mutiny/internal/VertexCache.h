@@ -0,0 +1,55 @@
+#ifndef MUTINY_ENGINE_INTERNAL_VERTEXCACHE_H
+#define MUTINY_ENGINE_INTERNAL_VERTEXCACHE_H
+
+#include "../Vector3.h"
+#include "../Vector2.h"
+#include "../Color.h"
+
+#include <vector>
+#include <map>
+
+namespace mutiny
+{
+
+namespace engine
+{
+
+namespace internal
+{
+
+struct VertexKey
+{
+  float values[12];
+
+  bool operator<(const VertexKey& other) const;
+};
+
+// Welds identical vertices together while a mesh is being built so that
+// faces sharing a corner also share an index.
+class VertexCache
+{
+public:
+  std::vector<Vector3> vertices;
+  std::vector<Vector3> normals;
+  std::vector<Vector2> uv;
+  std::vector<Color> colors;
+
+  int add(Vector3 position, Vector3 normal, Vector2 coord);
+  int add(Vector3 position, Vector3 normal, Vector2 coord, Color color);
+  void clear();
+
+private:
+  std::map<VertexKey, int> indices;
+
+  int add(Vector3 position, Vector3 normal, Vector2 coord, Color color, bool hasColor);
+
+};
+
+}
+
+}
+
+}
+
+#endif
+
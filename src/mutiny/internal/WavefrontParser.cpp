@@ -1,5 +1,6 @@
 #include "WavefrontParser.h"
 #include "Util.h"
+#include "CWrapper.h"
 #include "../Application.h"
 #include "../Exception.h"
 
@@ -9,6 +10,8 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <cstring>
+#include <cstdlib>
 
 namespace mutiny
 {
@@ -19,20 +22,250 @@ namespace engine
 namespace internal
 {
 
-WavefrontParser::WavefrontParser(std::string path)
+static const int COUNT_PASS = 0;
+static const int PARSE_PASS = 1;
+static const int BUILD_PASS = 2;
+
+static bool isSpace(char c)
 {
-  std::string line;
-  std::vector<std::string> splitLine;
-  std::vector<std::string> subSplit;
-  std::vector<Vector3> vertexPositions;
-  std::vector<Vector3> vertexNormals;
-  std::vector<Vector2> vertexCoords;
-  std::ifstream file;
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+static bool isEnd(char c)
+{
+  return c == '\n' || c == '\0';
+}
+
+static void skipSpace(const char*& c)
+{
+  while(isSpace(*c) == true)
+  {
+    c++;
+  }
+}
+
+static void skipLine(const char*& c)
+{
+  while(isEnd(*c) == false)
+  {
+    c++;
+  }
+
+  // A stray NUL in the file ends a line just as a newline does so it is
+  // stepped over too, otherwise the chunk loops would never move past it
+  if(*c == '\n' || *c == '\0')
+  {
+    c++;
+  }
+}
+
+// Finds the next whitespace separated token on the current line without
+// copying it
+static bool nextToken(const char*& c, const char*& start, const char*& end)
+{
+  skipSpace(c);
+  start = c;
+
+  while(isSpace(*c) == false && isEnd(*c) == false)
+  {
+    c++;
+  }
+
+  end = c;
+
+  return start != end;
+}
+
+static bool tokenEquals(const char* start, const char* end, const char* keyword)
+{
+  size_t length = strlen(keyword);
+
+  return (size_t)(end - start) == length && memcmp(start, keyword, length) == 0;
+}
+
+static double readFloat(const char*& c)
+{
+  const char* start = NULL;
+  const char* end = NULL;
+
+  if(nextToken(c, start, end) == false)
+  {
+    throw Exception("Missing number in model");
+  }
 
+  static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+    1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+    1e20, 1e21, 1e22 };
+
+  const char* p = start;
+  bool negative = false;
+  bool number = false;
+  unsigned long long mantissa = 0;
+  int digits = 0;
+  int exponent = 0;
+
+  if(*p == '-' || *p == '+')
+  {
+    negative = *p == '-';
+    p++;
+  }
+
+  // Leading zeros do not count towards the digits the mantissa can hold
+  for(; *p >= '0' && *p <= '9'; p++)
+  {
+    mantissa = mantissa * 10 + (*p - '0');
+    number = true;
+    if(mantissa > 0) digits++;
+  }
+
+  if(*p == '.')
+  {
+    for(p++; *p >= '0' && *p <= '9'; p++)
+    {
+      mantissa = mantissa * 10 + (*p - '0');
+      number = true;
+      if(mantissa > 0) digits++;
+      exponent--;
+    }
+  }
+
+  if(*p == 'e' || *p == 'E')
+  {
+    const char* e = p + 1;
+    bool negativeExponent = false;
+    int value = 0;
+
+    if(*e == '-' || *e == '+')
+    {
+      negativeExponent = *e == '-';
+      e++;
+    }
+
+    if(*e >= '0' && *e <= '9')
+    {
+      for(; *e >= '0' && *e <= '9' && value < 10000; e++)
+      {
+        value = value * 10 + (*e - '0');
+      }
+
+      exponent += negativeExponent ? -value : value;
+      p = e;
+    }
+  }
+
+  // While the mantissa is exact in a double and the power of ten is too,
+  // one multiply or divide is correctly rounded and so matches strtod.
+  // Anything else (long mantissas, large exponents, inf, nan, hex) goes
+  // to strtod itself.
+  if(number == true && digits <= 15 && exponent >= -22 && exponent <= 22 &&
+    (isSpace(*p) == true || isEnd(*p) == true))
+  {
+    double value = (double)mantissa;
+
+    if(exponent < 0)
+    {
+      value /= powers[-exponent];
+    }
+    else
+    {
+      value *= powers[exponent];
+    }
+
+    return negative ? -value : value;
+  }
+
+  return strtod(start, NULL);
+}
+
+static int readInt(const char*& c)
+{
+  bool negative = false;
+  int value = 0;
+
+  if(*c == '-' || *c == '+')
+  {
+    negative = *c == '-';
+    c++;
+  }
+
+  for(; *c >= '0' && *c <= '9'; c++)
+  {
+    value = value * 10 + (*c - '0');
+  }
+
+  return negative ? -value : value;
+}
+
+// OBJ indices start at one and negative ones count back from the most
+// recently declared element
+static int resolveIndex(int index, size_t count)
+{
+  if(index < 0)
+  {
+    index += count;
+  }
+  else
+  {
+    index--;
+  }
+
+  if(index < 0 || index >= (int)count)
+  {
+    throw Exception("Face index out of range in model");
+  }
+
+  return index;
+}
+
+// Reads one "position/coord/normal" corner straight from the buffer
+static bool readVertexReference(const char*& c, VertexReference& reference,
+  size_t positions, size_t coords, size_t normals)
+{
+  skipSpace(c);
+
+  if(isEnd(*c) == true)
+  {
+    return false;
+  }
+
+  reference.coord = -1;
+  reference.normal = -1;
+  reference.position = resolveIndex(readInt(c), positions);
+
+  if(*c == '/')
+  {
+    c++;
+
+    if(*c != '/' && isSpace(*c) == false && isEnd(*c) == false)
+    {
+      reference.coord = resolveIndex(readInt(c), coords);
+    }
+
+    if(*c == '/')
+    {
+      c++;
+
+      if(isSpace(*c) == false && isEnd(*c) == false)
+      {
+        reference.normal = resolveIndex(readInt(c), normals);
+      }
+    }
+  }
+
+  // Like atoi anything trailing the numbers is ignored
+  while(isSpace(*c) == false && isEnd(*c) == false)
+  {
+    c++;
+  }
+
+  return true;
+}
+
+WavefrontParser::WavefrontParser(std::string path)
+{
   shared<MaterialData> currentMaterial;
   shared<PartData> currentPart;
   shared<MaterialGroupData> currentMaterialGroup;
-  ref<FaceData> currentFace;
 
   _hasCoords = false;
   _hasNormals = false;
@@ -58,174 +291,148 @@ WavefrontParser::WavefrontParser(std::string path)
   currentPart->materialGroups.push_back(currentMaterialGroup);
   currentMaterialGroup->material = currentMaterial;
 
-  // Start parsing file
-
-  file.open(path.c_str());
+  // The whole file is read in one go and tokenized in place. The trailing
+  // null stops every scan so none of them need to check the length.
+  std::ifstream file(path.c_str(), std::ios::binary);
 
   if(file.is_open() == false)
   {
     throw Exception("Failed to open '" + path + "'");
   }
 
-  while(file.eof() == false)
-  {
-    getline(file, line);
-    splitLine.clear();
-    Util::splitStringWhitespace(line, splitLine);
+  file.seekg(0, std::ios::end);
+  std::vector<char> buffer((size_t)file.tellg() + 1, '\0');
+  file.seekg(0, std::ios::beg);
+  file.read(&buffer.at(0), buffer.size() - 1);
 
-    if(splitLine.size() < 1)
-    {
-      continue;
-    }
+  // Large files are split at line boundaries, one chunk per core. Small
+  // ones stay in a single chunk parsed on this thread.
+  size_t size = buffer.size() - 1;
+  size_t chunkCount = std::min((size_t)Thread::getProcessorCount(), (size_t)MAX_CHUNKS);
+  chunkCount = std::max((size_t)1, std::min(chunkCount, size / MIN_CHUNK_SIZE));
+  const char* begin = &buffer.at(0);
 
-    if(splitLine.at(0) == "mtllib")
-    {
-      parseMtl(splitLine.at(1));
-    }
-    else if(splitLine.at(0) == "v")
-    {
-      vertexPositions.push_back(Vector3(-atof(splitLine.at(1).c_str()),
-        atof(splitLine.at(2).c_str()),
-        atof(splitLine.at(3).c_str())));
-    }
-    else if(splitLine.at(0) == "vn")
-    {
-      vertexNormals.push_back(Vector3(atof(splitLine.at(1).c_str()),
-        atof(splitLine.at(2).c_str()),
-        atof(splitLine.at(3).c_str())));
-    }
-    else if(splitLine.at(0) == "vt")
-    {
-      vertexCoords.push_back(Vector2(atof(splitLine.at(1).c_str()),
-        -atof(splitLine.at(2).c_str())));
-    }
-    else if(splitLine.at(0) == "g" || splitLine.at(0) == "o")
-    {
-      currentPart.reset(new PartData());
-      modelData->parts.push_back(currentPart);
+  chunks.resize(chunkCount);
 
-      if(splitLine.size() >= 2)
-      {
-        currentPart->name = splitLine.at(1);
-      }
+  for(size_t i = 0; i < chunkCount; i++)
+  {
+    WavefrontChunk& chunk = chunks.at(i);
+    const char* end = &buffer.at(0) + size;
 
-      currentMaterialGroup.reset(new MaterialGroupData());
-      currentPart->materialGroups.push_back(currentMaterialGroup);
-      currentMaterialGroup->material = currentMaterial;
-    }
-    else if(splitLine.at(0) == "usemtl")
+    if(i < chunkCount - 1)
     {
-      if(splitLine.size() > 1)
-      {
-        currentMaterial = getMaterialData(splitLine.at(1));
-      }
-      else
-      {
-        currentMaterial = getMaterialData("noname");
-      }
+      end = (const char*)memchr(&buffer.at(0) + size * (i + 1) / chunkCount,
+        '\n', size - size * (i + 1) / chunkCount);
 
-      currentMaterialGroup.reset(new MaterialGroupData());
-      currentPart->materialGroups.push_back(currentMaterialGroup);
-      currentMaterialGroup->material = currentMaterial;
+      end = end == NULL ? &buffer.at(0) + size : end + 1;
     }
-    else if(splitLine.at(0) == "f")
-    {
-      splitLine = mungeSplitLine(splitLine);
-      shared<FaceData> currentFace(new FaceData());
-      currentMaterialGroup->faces.push_back(shared<FaceData>(currentFace));
-      subSplit.clear(); Util::splitString(splitLine.at(1), '/', subSplit);
 
-      currentFace->a.position = Vector3(vertexPositions.at(atoi(subSplit.at(0).c_str()) - 1));
-
-      if(subSplit.size() > 1 && subSplit.at(1) != "")
-      {
-        _hasCoords = true;
-        currentFace->a.coord = Vector2(vertexCoords.at(atoi(subSplit.at(1).c_str()) - 1));
-      }
+    chunk.parser = this;
+    chunk.begin = begin;
+    chunk.end = std::max(begin, end);
+    chunk.hasCoords = false;
+    chunk.hasNormals = false;
+    begin = chunk.end;
+  }
 
-      if(subSplit.size() > 2)
-      {
-        _hasNormals = true;
-        currentFace->a.normal = Vector3(vertexNormals.at(atoi(subSplit.at(2).c_str()) - 1));
-      }
+  // Counting the lines of each kind up front lets the arrays be sized once
+  // and tells every chunk where its vertices start
+  runChunks(COUNT_PASS);
 
-      subSplit.clear(); Util::splitString(splitLine.at(2), '/', subSplit);
+  size_t positions = 0;
+  size_t normals = 0;
+  size_t coords = 0;
 
-      currentFace->b.position = Vector3(vertexPositions.at(atoi(subSplit.at(0).c_str()) - 1));
+  for(size_t i = 0; i < chunks.size(); i++)
+  {
+    chunks.at(i).positionOffset = positions;
+    chunks.at(i).normalOffset = normals;
+    chunks.at(i).coordOffset = coords;
+    positions += chunks.at(i).positions;
+    normals += chunks.at(i).normals;
+    coords += chunks.at(i).coords;
+  }
 
-      if(subSplit.size() > 1 && subSplit.at(1) != "")
-      {
-        currentFace->b.coord = Vector2(vertexCoords.at(atoi(subSplit.at(1).c_str()) - 1));
-      }
+  vertexPositions.resize(positions);
+  vertexNormals.resize(normals);
+  vertexCoords.resize(coords);
 
-      if(subSplit.size() > 2)
-      {
-        currentFace->b.normal = Vector3(vertexNormals.at(atoi(subSplit.at(2).c_str()) - 1));
-      }
+  runChunks(PARSE_PASS);
 
-      subSplit.clear(); Util::splitString(splitLine.at(3), '/', subSplit);
+  // Groups and materials are rebuilt on this thread in file order. Each
+  // stretch of faces between two events becomes a run copied into its
+  // material group by the final pass.
+  for(size_t i = 0; i < chunks.size(); i++)
+  {
+    WavefrontChunk& chunk = chunks.at(i);
+    size_t face = 0;
 
-      currentFace->c.position = Vector3(vertexPositions.at(atoi(subSplit.at(0).c_str()) - 1));
+    for(size_t e = 0; e <= chunk.events.size(); e++)
+    {
+      size_t next = chunk.faces.size();
 
-      if(subSplit.size() > 1 && subSplit.at(1) != "")
+      if(e < chunk.events.size())
       {
-        currentFace->c.coord = Vector2(vertexCoords.at(atoi(subSplit.at(1).c_str()) - 1));
+        next = chunk.events.at(e).face;
       }
 
-      if(subSplit.size() > 2)
+      if(next > face)
       {
-        currentFace->c.normal = Vector3(vertexNormals.at(atoi(subSplit.at(2).c_str()) - 1));
+        WavefrontRun run;
+        run.materialGroup = currentMaterialGroup.get();
+        run.first = face;
+        run.count = next - face;
+        run.destination = currentMaterialGroup->faces.size();
+        currentMaterialGroup->faces.resize(run.destination + run.count);
+        chunk.runs.push_back(run);
+        face = next;
       }
 
-      if(splitLine.size() >= 5)
+      if(e >= chunk.events.size())
       {
-        shared<FaceData> currentFace(new FaceData());
-        currentMaterialGroup->faces.push_back(shared<FaceData>(currentFace));
-        subSplit.clear(); Util::splitString(splitLine.at(3), '/', subSplit);
-
-        currentFace->a.position = Vector3(vertexPositions.at(atoi(subSplit.at(0).c_str()) - 1));
-
-        if(subSplit.size() > 1 && subSplit.at(1) != "")
-        {
-          currentFace->a.coord = Vector2(vertexCoords.at(atoi(subSplit.at(1).c_str()) - 1));
-        }
-
-        if(subSplit.size() > 2)
-        {
-          currentFace->a.normal = Vector3(vertexNormals.at(atoi(subSplit.at(2).c_str()) - 1));
-        }
-
-        subSplit.clear(); Util::splitString(splitLine.at(4), '/', subSplit);
-
-        currentFace->b.position = Vector3(vertexPositions.at(atoi(subSplit.at(0).c_str()) - 1));
+        break;
+      }
 
-        if(subSplit.size() > 1 && subSplit.at(1) != "")
-        {
-          currentFace->b.coord = Vector2(vertexCoords.at(atoi(subSplit.at(1).c_str()) - 1));
-        }
+      WavefrontEvent& event = chunk.events.at(e);
 
-        if(subSplit.size() > 2)
-        {
-          currentFace->b.normal = Vector3(vertexNormals.at(atoi(subSplit.at(2).c_str()) - 1));
-        }
+      if(event.keyword == "g" || event.keyword == "o")
+      {
+        currentPart.reset(new PartData());
+        modelData->parts.push_back(currentPart);
+        currentPart->name = event.name;
 
-        subSplit.clear(); Util::splitString(splitLine.at(1), '/', subSplit);
+        currentMaterialGroup.reset(new MaterialGroupData());
+        currentPart->materialGroups.push_back(currentMaterialGroup);
+        currentMaterialGroup->material = currentMaterial;
+      }
+      else if(event.keyword == "usemtl")
+      {
+        currentMaterial = getMaterialData(event.name);
 
-        currentFace->c.position = Vector3(vertexPositions.at(atoi(subSplit.at(0).c_str()) - 1));
+        currentMaterialGroup.reset(new MaterialGroupData());
+        currentPart->materialGroups.push_back(currentMaterialGroup);
+        currentMaterialGroup->material = currentMaterial;
+      }
+      else if(event.keyword == "mtllib")
+      {
+        parseMtl(event.name);
+      }
+    }
 
-        if(subSplit.size() > 1 && subSplit.at(1) != "")
-        {
-          currentFace->c.coord = Vector2(vertexCoords.at(atoi(subSplit.at(1).c_str()) - 1));
-        }
+    if(chunk.hasCoords == true)
+    {
+      _hasCoords = true;
+    }
 
-        if(subSplit.size() > 2)
-        {
-          currentFace->c.normal = Vector3(vertexNormals.at(atoi(subSplit.at(2).c_str()) - 1));
-        }
-      }
+    if(chunk.hasNormals == true)
+    {
+      _hasNormals = true;
     }
   }
 
+  runChunks(BUILD_PASS);
+  chunks.clear();
+
   for(size_t a = 0; a < modelData->parts.size(); a++)
   {
     for(size_t b = 0; b < modelData->parts.at(a)->materialGroups.size(); b++)
@@ -251,6 +458,247 @@ WavefrontParser::WavefrontParser(std::string path)
   obtainSizes();
 }
 
+void WavefrontParser::runPass(void* data)
+{
+  WavefrontChunk* chunk = (WavefrontChunk*)data;
+
+  // Exceptions cannot cross threads so they are carried back as text
+  try
+  {
+    if(chunk->pass == COUNT_PASS)
+    {
+      chunk->parser->countLines(*chunk);
+    }
+    else if(chunk->pass == PARSE_PASS)
+    {
+      chunk->parser->parseLines(*chunk);
+    }
+    else
+    {
+      chunk->parser->buildFaces(*chunk);
+    }
+  }
+  catch(std::exception& e)
+  {
+    chunk->error = e.what();
+  }
+}
+
+void WavefrontParser::runChunks(int pass)
+{
+  std::vector<shared<Thread> > threads;
+
+  for(size_t i = 0; i < chunks.size(); i++)
+  {
+    chunks.at(i).pass = pass;
+  }
+
+  // The first chunk is handled by this thread rather than waiting idle
+  for(size_t i = 1; i < chunks.size(); i++)
+  {
+    threads.push_back(Thread::create(runPass, &chunks.at(i)));
+  }
+
+  runPass(&chunks.at(0));
+  threads.clear();
+
+  for(size_t i = 0; i < chunks.size(); i++)
+  {
+    if(chunks.at(i).error != "")
+    {
+      throw Exception(chunks.at(i).error);
+    }
+  }
+}
+
+void WavefrontParser::countLines(WavefrontChunk& chunk)
+{
+  const char* c = chunk.begin;
+  const char* start = NULL;
+  const char* end = NULL;
+
+  chunk.positions = 0;
+  chunk.normals = 0;
+  chunk.coords = 0;
+  chunk.faceLines = 0;
+
+  // Tokenized exactly as parseLines does since the chunks after this one
+  // index their vertices from these counts
+  while(c < chunk.end)
+  {
+    if(nextToken(c, start, end) == true)
+    {
+      if(tokenEquals(start, end, "v") == true) chunk.positions++;
+      else if(tokenEquals(start, end, "vn") == true) chunk.normals++;
+      else if(tokenEquals(start, end, "vt") == true) chunk.coords++;
+      else if(tokenEquals(start, end, "f") == true) chunk.faceLines++;
+    }
+
+    skipLine(c);
+  }
+}
+
+void WavefrontParser::parseLines(WavefrontChunk& chunk)
+{
+  const char* c = chunk.begin;
+  const char* start = NULL;
+  const char* end = NULL;
+  size_t positions = chunk.positionOffset;
+  size_t normals = chunk.normalOffset;
+  size_t coords = chunk.coordOffset;
+
+  // Quads become two triangles so this is enough for any mix of the two
+  chunk.faces.reserve(chunk.faceLines * 2);
+
+  while(c < chunk.end)
+  {
+    if(nextToken(c, start, end) == false)
+    {
+      skipLine(c);
+      continue;
+    }
+
+    if(tokenEquals(start, end, "v") == true)
+    {
+      Vector3& position = vertexPositions[positions];
+      position.x = -readFloat(c);
+      position.y = readFloat(c);
+      position.z = readFloat(c);
+      positions++;
+    }
+    else if(tokenEquals(start, end, "vn") == true)
+    {
+      Vector3& normal = vertexNormals[normals];
+      normal.x = readFloat(c);
+      normal.y = readFloat(c);
+      normal.z = readFloat(c);
+      normals++;
+    }
+    else if(tokenEquals(start, end, "vt") == true)
+    {
+      Vector2& coord = vertexCoords[coords];
+      coord.x = readFloat(c);
+      coord.y = -readFloat(c);
+      coords++;
+    }
+    else if(tokenEquals(start, end, "f") == true)
+    {
+      parseFace(c, chunk, positions, coords, normals);
+    }
+    else if(tokenEquals(start, end, "g") == true || tokenEquals(start, end, "o") == true ||
+      tokenEquals(start, end, "usemtl") == true || tokenEquals(start, end, "mtllib") == true)
+    {
+      WavefrontEvent event;
+      event.keyword = std::string(start, end);
+      event.face = chunk.faces.size();
+
+      if(nextToken(c, start, end) == true)
+      {
+        event.name = std::string(start, end);
+      }
+      else if(event.keyword == "usemtl")
+      {
+        event.name = "noname";
+      }
+      else if(event.keyword == "mtllib")
+      {
+        throw Exception("Missing material library in '" + foldername + "/" + filename + "'");
+      }
+
+      chunk.events.push_back(event);
+    }
+
+    skipLine(c);
+  }
+}
+
+// Indices are checked against what has been declared before the face, which
+// for a chunk is everything in the chunks ahead of it plus its own lines
+// so far. Only once every chunk is parsed can they be followed.
+void WavefrontParser::parseFace(const char*& c, WavefrontChunk& chunk,
+  size_t positions, size_t coords, size_t normals)
+{
+  VertexReference references[4];
+  int count = 0;
+
+  // Only triangles and quads are supported, extra corners are ignored
+  while(count < 4 && readVertexReference(c, references[count],
+    positions, coords, normals) == true)
+  {
+    count++;
+  }
+
+  if(count < 3)
+  {
+    throw Exception("Face with fewer than three vertices in model");
+  }
+
+  // The x axis is mirrored on load so the winding is reversed to match
+  FaceReference face;
+  face.a = references[2];
+  face.b = references[1];
+  face.c = references[0];
+  chunk.faces.push_back(face);
+
+  if(references[2].coord != -1)
+  {
+    chunk.hasCoords = true;
+  }
+
+  if(references[2].normal != -1)
+  {
+    chunk.hasNormals = true;
+  }
+
+  if(count == 4)
+  {
+    face.a = references[0];
+    face.b = references[3];
+    face.c = references[2];
+    chunk.faces.push_back(face);
+  }
+}
+
+void WavefrontParser::buildFaces(WavefrontChunk& chunk)
+{
+  for(size_t r = 0; r < chunk.runs.size(); r++)
+  {
+    WavefrontRun& run = chunk.runs.at(r);
+    FaceData* destination = &run.materialGroup->faces.at(run.destination);
+
+    for(size_t f = 0; f < run.count; f++)
+    {
+      FaceReference& face = chunk.faces[run.first + f];
+
+      destination[f].a = getVertex(face.a);
+      destination[f].b = getVertex(face.b);
+      destination[f].c = getVertex(face.c);
+    }
+  }
+
+  // Freed here so each thread releases its own
+  std::vector<FaceReference>().swap(chunk.faces);
+}
+
+VertexData WavefrontParser::getVertex(VertexReference& reference)
+{
+  VertexData rtn;
+
+  rtn.position = vertexPositions[reference.position];
+
+  if(reference.coord != -1)
+  {
+    rtn.coord = vertexCoords[reference.coord];
+  }
+
+  if(reference.normal != -1)
+  {
+    rtn.normal = vertexNormals[reference.normal];
+  }
+
+  return rtn;
+}
+
 bool WavefrontParser::hasNormals()
 {
   return _hasNormals;
@@ -284,21 +732,24 @@ void WavefrontParser::obtainSizes()
     {
       materialGroup = part->materialGroups.at(b);
 
-      for(size_t c = 0; c < materialGroup->faces.size(); c++)
+      // Going through ref for every face costs more than the parse itself
+      std::vector<FaceData>& faces = materialGroup->faces;
+
+      for(size_t c = 0; c < faces.size(); c++)
       {
         for(size_t d = 0; d < 3; d++)
         {
           if(d == 0)
           {
-            current = materialGroup->faces.at(c)->a.position;
+            current = faces[c].a.position;
           }
           else if(d == 1)
           {
-            current = materialGroup->faces.at(c)->b.position;
+            current = faces[c].b.position;
           }
           else
           {
-            current = materialGroup->faces.at(c)->c.position;
+            current = faces[c].c.position;
           }
         }
 
@@ -513,23 +964,6 @@ shared<MaterialData> WavefrontParser::getMaterialData(std::string name)
   return modelData->materials.at(0);
 }
 
-std::vector<std::string> WavefrontParser::mungeSplitLine(std::vector<std::string> splitLine)
-{
-  std::vector<std::string> rtn;
-
-  rtn.push_back(splitLine.at(0));
-  rtn.push_back(splitLine.at(3));
-  rtn.push_back(splitLine.at(2));
-  rtn.push_back(splitLine.at(1));
-
-  if(splitLine.size() > 4)
-  {
-    rtn.push_back(splitLine.at(4));
-  }
-
-  return rtn;
-}
-
 }
 
 }
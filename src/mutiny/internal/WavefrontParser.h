@@ -27,7 +27,7 @@ struct MaterialData : public enable_ref
 
 };
 
-struct VertexData : public enable_ref
+struct VertexData
 {
   Vector3 position;
   Vector3 normal;
@@ -35,7 +35,7 @@ struct VertexData : public enable_ref
 
 };
 
-struct FaceData : public enable_ref
+struct FaceData
 {
   VertexData a;
   VertexData b;
@@ -46,7 +46,7 @@ struct FaceData : public enable_ref
 struct MaterialGroupData : public enable_ref
 {
   ref<MaterialData> material;
-  std::vector<shared<FaceData> > faces;
+  std::vector<FaceData> faces;
   
 };
 
@@ -68,6 +68,71 @@ struct ModelData : public enable_ref
 
 };
 
+struct VertexReference
+{
+  int position;
+  int coord;
+  int normal;
+
+};
+
+struct FaceReference
+{
+  VertexReference a;
+  VertexReference b;
+  VertexReference c;
+
+};
+
+// A g, o, usemtl or mtllib line, kept with the number of faces the chunk
+// had read before it so groups can be rebuilt in file order
+struct WavefrontEvent
+{
+  std::string keyword;
+  std::string name;
+  size_t face;
+
+};
+
+// Faces of a chunk that land in one material group
+struct WavefrontRun
+{
+  MaterialGroupData* materialGroup;
+  size_t first;
+  size_t count;
+  size_t destination;
+
+};
+
+class WavefrontParser;
+
+// A range of whole lines of the file parsed on a thread of its own. Its
+// vertices are written straight into the shared arrays from the offsets
+// given by the chunks before it.
+struct WavefrontChunk
+{
+  WavefrontParser* parser;
+  int pass;
+  const char* begin;
+  const char* end;
+
+  size_t positions;
+  size_t normals;
+  size_t coords;
+  size_t faceLines;
+  size_t positionOffset;
+  size_t normalOffset;
+  size_t coordOffset;
+
+  std::vector<FaceReference> faces;
+  std::vector<WavefrontEvent> events;
+  std::vector<WavefrontRun> runs;
+  bool hasCoords;
+  bool hasNormals;
+  std::string error;
+
+};
+
 class WavefrontParser : public enable_ref
 {
 private:
@@ -77,11 +142,27 @@ private:
   bool _hasNormals;
   bool _hasCoords;
 
+  static const int MIN_CHUNK_SIZE = 1024 * 1024;
+  static const int MAX_CHUNKS = 32;
+
+  std::vector<Vector3> vertexPositions;
+  std::vector<Vector3> vertexNormals;
+  std::vector<Vector2> vertexCoords;
+  std::vector<WavefrontChunk> chunks;
+
+  static void runPass(void* data);
+
   shared<MaterialData> getMaterialData(std::string name);
   void parseMtl(std::string filename);
+  void runChunks(int pass);
+  void countLines(WavefrontChunk& chunk);
+  void parseLines(WavefrontChunk& chunk);
+  void parseFace(const char*& c, WavefrontChunk& chunk, size_t positions,
+    size_t coords, size_t normals);
+  void buildFaces(WavefrontChunk& chunk);
+  VertexData getVertex(VertexReference& reference);
   void obtainSizes();
   Vector3 absVec3(Vector3 input);
-  std::vector<std::string> mungeSplitLine(std::vector<std::string> splitLine);
 
 public:
   WavefrontParser(std::string path);
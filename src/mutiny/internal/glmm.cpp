@@ -1,5 +1,6 @@
 #include "glmm.h"
 #include "../Application.h"
+#include "../Shader.h"
 #include "../Exception.h"
 
 namespace gl
@@ -122,6 +123,27 @@ shared<Uint> Uint::genRenderbuffer()
   return rtn;
 }
 
+shared<Uint> Uint::genVertexArray()
+{
+  shared<Uint> rtn(new Uint());
+
+  if(glGenVertexArrays == NULL || glBindVertexArray == NULL)
+  {
+    throw mutiny::engine::Exception("Vertex arrays not supported by system");
+  }
+
+  glGenVertexArrays(1, &rtn->uint);
+
+  if(rtn->uint == 0)
+  {
+    throw mutiny::engine::Exception("Failed to allocate vertex array");
+  }
+
+  rtn->type = VERTEXARRAY;
+
+  return rtn;
+}
+
 GLuint Uint::getGLuint()
 {
   return uint;
@@ -155,6 +177,10 @@ Uint::~Uint()
   {
     glDeleteProgram(uint);
   }
+  else if(type == VERTEXARRAY)
+  {
+    mutiny::engine::Shader::deleteVertexArray(uint);
+  }
 }
 
 }
@@ -2,8 +2,7 @@
 #define GLMM_H
 
 #include "../ref.h"
-
-#include <GL/glew.h>
+#include "OpenGl.h"
 
 namespace gl
 {
@@ -15,6 +14,7 @@ public:
   static shared<Uint> genTexture();
   static shared<Uint> genFramebuffer();
   static shared<Uint> genRenderbuffer();
+  static shared<Uint> genVertexArray();
   static shared<Uint> createVertexShader();
   static shared<Uint> createFragmentShader();
   static shared<Uint> createProgram();
@@ -31,6 +31,7 @@ private:
   static const int VERTEXSHADER = 4;
   static const int FRAGMENTSHADER = 5;
   static const int PROGRAM = 6;
+  static const int VERTEXARRAY = 7;
 
   GLuint uint;
   int type;
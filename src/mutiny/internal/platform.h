@@ -13,18 +13,34 @@
   #define HAS_TR1_NAMESPACE
 #endif
 
+// Headless builds (mutt -d MUTINY_HEADLESS) have no window, input or audio.
+// GL calls are routed to the stubs in internal/NullGl.cpp and the main loop
+// is driven by a fixed timestep clock.
+#ifdef MUTINY_HEADLESS
+  #undef USE_SDL
+  #undef USE_GLUT
+  #undef USE_OPENAL
+  #define USE_HEADLESS
+#endif
+
 #ifdef _WIN32
   #define USE_WINAPI 1
 #endif
 
 #ifdef HAS_TR1_NAMESPACE
   #include <tr1/memory>
+  #include <tr1/unordered_map>
   #define shared std::tr1::shared_ptr
   #define weak std::tr1::weak_ptr
+  #define unordered std::tr1::unordered_map
+  #define unordered_multi std::tr1::unordered_multimap
 #else
   #include <memory>
+  #include <unordered_map>
   #define shared std::shared_ptr
   #define weak std::weak_ptr
+  #define unordered std::unordered_map
+  #define unordered_multi std::unordered_multimap
 #endif
 
 #endif
@@ -9,6 +9,7 @@
 #include "Debug.h"
 #include "MeshFilter.h"
 #include "MeshRenderer.h"
+#include "StaticBatchingUtility.h"
 #include "Mesh.h"
 #include "Resources.h"
 #include "PrimitiveType.h"
@@ -24,6 +25,7 @@
 #include "Color.h"
 #include "Transform.h"
 #include "Time.h"
+#include "Profiler.h"
 #include "ParticleEmitter.h"
 #include "Particle.h"
 #include "ParticleRenderer.h"
@@ -16,8 +16,11 @@
 #include "../GameObject.h"
 #include "../Transform.h"
 #include "../Input.h"
+#include "../internal/OpenGl.h"
 
-#include <GL/glew.h>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
 
 namespace mutiny
 {
@@ -27,6 +30,15 @@ namespace engine
 
 Canvas* Canvas::currentActive = NULL;
 
+// Rounded as Texture2d stores a Color
+static unsigned char toByte(float value)
+{
+  value = value * 255.0f + 0.5f;
+  value = value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value);
+
+  return (unsigned char)value;
+}
+
 Canvas::~Canvas()
 {
 
@@ -237,14 +249,33 @@ void Canvas::drawText(Vector2 position, Font* font, std::string text)
   fillRectangle(Rect(position.x, position.y, 75, 25), Color(0, 0, 0));
 }
 
+// Covers the pixels the integer corner up to, but not including, the far
+// edges would, as setting them one at a time did
 void Canvas::fillRectangle(Rect rect, Color color)
 {
-  for(int y = rect.y; y < rect.y + rect.height; y++)
+  int minX = std::max((int)rect.x, 0);
+  int minY = std::max((int)rect.y, 0);
+  int maxX = std::min((int)ceil(rect.x + rect.width), texture->getWidth());
+  int maxY = std::min((int)ceil(rect.y + rect.height), texture->getHeight());
+
+  if(minX >= maxX || minY >= maxY)
   {
-    for(int x = rect.x; x < rect.x + rect.width; x++)
-    {
-      texture->setPixel(x, y, color);
-    }
+    return;
+  }
+
+  unsigned char rgba[4] = { toByte(color.r), toByte(color.g), toByte(color.b),
+    toByte(color.a) };
+
+  std::vector<unsigned char> row((maxX - minX) * 4);
+
+  for(size_t i = 0; i < row.size(); i += 4)
+  {
+    memcpy(&row[i], rgba, 4);
+  }
+
+  for(int y = minY; y < maxY; y++)
+  {
+    texture->setPixels32(minX, y, maxX - minX, 1, &row[0]);
   }
 
   needsApply = true;
@@ -253,3 +284,4 @@ void Canvas::fillRectangle(Rect rect, Color color)
 }
 
 }
+